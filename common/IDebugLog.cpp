@@ -2,19 +2,106 @@
 #include <share.h>
 #include "common/IFileStream.h"
 #include <shlobj.h>
+#include <atomic>
+#include <string>
+#include <thread>
 
 std::FILE			* IDebugLog::logFile = NULL;
 char				IDebugLog::sourceBuf[16] = { 0 };
 char				IDebugLog::headerText[16] = { 0 };
-char				IDebugLog::formatBuf[8192] = { 0 };
+thread_local char	IDebugLog::formatBuf[8192] = { 0 };
 int					IDebugLog::indentLevel = 0;
 int					IDebugLog::rightMargin = 0;
 int					IDebugLog::cursorPos = 0;
 int					IDebugLog::inBlock = 0;
 bool				IDebugLog::autoFlush = true;
+bool				IDebugLog::async = false;
 IDebugLog::LogLevel	IDebugLog::logLevel = IDebugLog::kLevel_DebugMessage;
 IDebugLog::LogLevel	IDebugLog::printLevel = IDebugLog::kLevel_Message;
 
+namespace
+{
+	/**
+	 *	Bounded multi-producer queue of finished log lines
+	 *	
+	 *	Producers claim a record with a CAS on the write position and never block; when every record is in use
+	 *	the line is dropped and counted instead. Records are consumed in order by whoever holds drainLock,
+	 *	normally the writer thread. Lines longer than the inline buffer are copied to the heap.
+	 */
+	enum
+	{
+		kNumRecords = 0x1000,
+		kRecordTextSize = 0x100 - 3 * sizeof(UInt32),
+		kWriteBufferSize = 0x10000,
+		kWakeInterval = kNumRecords / 8,	// producers wake the writer every this many lines
+		kWriterSleepMS = 20,
+		kDrainLockTimeoutMS = 200
+	};
+
+	struct LogRecord
+	{
+		std::atomic<UInt32>	sequence;
+		UInt32				length;
+		char				* longText;
+		char				text[kRecordTextSize];
+	};
+
+	LogRecord				s_records[kNumRecords];
+	std::atomic<UInt32>		s_writePos = 0;
+	UInt32					s_readPos = 0;
+	std::atomic<UInt32>		s_numDropped = 0;
+	UInt32					s_numDroppedReported = 0;
+
+	std::atomic_flag		s_drainLock = ATOMIC_FLAG_INIT;
+	std::atomic<bool>		s_stopWriter = false;
+	HANDLE					s_wakeWriter = NULL;
+	char					s_writeBuffer[kWriteBufferSize];
+
+	thread_local std::string	s_lineBuffer;
+
+	LPTOP_LEVEL_EXCEPTION_FILTER	s_prevExceptionFilter = NULL;
+
+	bool PushRecord(const char * text, UInt32 length)
+	{
+		UInt32 pos = s_writePos.load(std::memory_order_relaxed);
+		LogRecord * record;
+		while(true)
+		{
+			record = &s_records[pos & (kNumRecords - 1)];
+			SInt32 diff = (SInt32)(record->sequence.load(std::memory_order_acquire) - pos);
+			if(!diff)
+			{
+				if(s_writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if(diff < 0)
+			{
+				s_numDropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else
+				pos = s_writePos.load(std::memory_order_relaxed);
+		}
+
+		record->length = length;
+		if(length <= kRecordTextSize)
+		{
+			record->longText = NULL;
+			memcpy(record->text, text, length);
+		}
+		else
+		{
+			record->longText = (char *)malloc(length);
+			memcpy(record->longText, text, length);
+		}
+		record->sequence.store(pos + 1, std::memory_order_release);
+
+		if(!(pos % kWakeInterval) && s_wakeWriter)
+			SetEvent(s_wakeWriter);
+		return true;
+	}
+}
+
 IDebugLog::IDebugLog()
 {
 	//
@@ -27,6 +114,15 @@ IDebugLog::IDebugLog(const char * name)
 
 IDebugLog::~IDebugLog()
 {
+	if(async)
+	{
+		// the writer thread isn't joined, that would deadlock under the loader lock; draining here under
+		// drainLock is enough to make sure it is done with the file
+		s_stopWriter = true;
+		DrainQueue(false);
+		async = false;
+	}
+
 	if(logFile)
 		fclose(logFile);
 }
@@ -204,6 +300,172 @@ void IDebugLog::SetAutoFlush(bool inAutoFlush)
 	autoFlush = inAutoFlush;
 }
 
+/**
+ *	Enable/disable asynchronous writing
+ *	
+ *	When enabled, each finished line is queued and a background thread writes the queue to the file
+ *	in large batches. The queue is also flushed by Flush(), on an unhandled exception and on destruction.
+ *	Lines that arrive while the queue is full are dropped; the writer notes how many in the log.
+ *	
+ *	@param inAsync async state
+ */
+void IDebugLog::SetAsync(bool inAsync)
+{
+	if(inAsync == async)
+		return;
+
+	if(inAsync)
+	{
+		if(!s_wakeWriter)
+		{
+			for(UInt32 i = 0; i < kNumRecords; i++)
+				s_records[i].sequence.store(i, std::memory_order_relaxed);
+			s_wakeWriter = CreateEvent(NULL, FALSE, FALSE, NULL);
+			std::thread(WriterThread).detach();
+			s_prevExceptionFilter = SetUnhandledExceptionFilter(FlushLogOnCrash);
+		}
+		async = true;
+	}
+	else
+	{
+		// lines queued so far still go out before any direct writes
+		async = false;
+		Flush();
+	}
+}
+
+/**
+ *	Write out every queued line
+ *	
+ *	Waits for the writer thread if it is in the middle of a batch, the lock is only ever taken over
+ *	after a crash and on destruction.
+ */
+void IDebugLog::Flush(void)
+{
+	if(s_wakeWriter)
+		DrainQueue(true);
+	if(logFile)
+		fflush(logFile);
+}
+
+LONG WINAPI IDebugLog::FlushLogOnCrash(EXCEPTION_POINTERS * info)
+{
+	// the crashed thread may be the one holding drainLock
+	DrainQueue(false);
+	if(logFile)
+		fflush(logFile);
+	return s_prevExceptionFilter ? s_prevExceptionFilter(info) : EXCEPTION_CONTINUE_SEARCH;
+}
+
+/**
+ *	Returns the number of lines dropped because the async queue was full
+ */
+UInt32 IDebugLog::GetDroppedCount(void)
+{
+	return s_numDropped.load(std::memory_order_relaxed);
+}
+
+void IDebugLog::WriterThread(void)
+{
+	while(!s_stopWriter)
+	{
+		WaitForSingleObject(s_wakeWriter, kWriterSleepMS);
+		DrainQueue(true);
+	}
+}
+
+/**
+ *	Moves queued records to the file in kWriteBufferSize batches
+ *	
+ *	@param waitForLock if false, the lock is taken over after kDrainLockTimeoutMS, since the thread holding it
+ *	may have been terminated (process exit) or be the one that crashed
+ */
+void IDebugLog::DrainQueue(bool waitForLock)
+{
+	DWORD startTime = GetTickCount();
+	while(s_drainLock.test_and_set(std::memory_order_acquire))
+	{
+		if(!waitForLock && (GetTickCount() - startTime > kDrainLockTimeoutMS))
+			break;
+		Sleep(0);
+	}
+
+	if(waitForLock && s_stopWriter)
+	{
+		s_drainLock.clear(std::memory_order_release);
+		return;
+	}
+
+	UInt32 bufferPos = 0;
+	auto write = [&](const char * text, UInt32 length)
+	{
+		if(!logFile)
+			return;
+		if(bufferPos + length > kWriteBufferSize)
+		{
+			fwrite(s_writeBuffer, 1, bufferPos, logFile);
+			bufferPos = 0;
+			if(length > kWriteBufferSize)
+			{
+				fwrite(text, 1, length, logFile);
+				return;
+			}
+		}
+		memcpy(s_writeBuffer + bufferPos, text, length);
+		bufferPos += length;
+	};
+
+	while(true)
+	{
+		LogRecord * record = &s_records[s_readPos & (kNumRecords - 1)];
+		if(record->sequence.load(std::memory_order_acquire) != s_readPos + 1)
+			break;
+
+		if(record->longText)
+		{
+			write(record->longText, record->length);
+			free(record->longText);
+		}
+		else
+			write(record->text, record->length);
+
+		record->sequence.store(s_readPos + kNumRecords, std::memory_order_release);
+		s_readPos++;
+	}
+
+	UInt32 numDropped = s_numDropped.load(std::memory_order_relaxed);
+	if(numDropped != s_numDroppedReported)
+	{
+		char dropBuf[96];
+		int length = sprintf_s(dropBuf, sizeof(dropBuf), "IDebugLog: %u lines dropped, log queue was full\n", numDropped - s_numDroppedReported);
+		write(dropBuf, length);
+		s_numDroppedReported = numDropped;
+	}
+
+	if(logFile && bufferPos)
+	{
+		fwrite(s_writeBuffer, 1, bufferPos, logFile);
+		fflush(logFile);
+	}
+
+	s_drainLock.clear(std::memory_order_release);
+}
+
+/**
+ *	Sends text to the current line, or straight to the file when not async
+ */
+void IDebugLog::WriteText(const char * buf, UInt32 length)
+{
+	if(async)
+		s_lineBuffer.append(buf, length);
+	else if(logFile)
+	{
+		fwrite(buf, 1, length, logFile);
+		if(autoFlush)
+			fflush(logFile);
+	}
+}
+
 /**
  *	Print spaces to the log
  *	
@@ -213,21 +475,33 @@ void IDebugLog::PrintSpaces(int numSpaces)
 {
 	int	originalNumSpaces = numSpaces;
 
-	if(logFile)
+	if(logFile || async)
 	{
+		char	spaces[64];
+		UInt32	length = 0;
+
 		while(numSpaces > 0)
 		{
 			if(numSpaces >= TabSize())
 			{
 				numSpaces -= TabSize();
-				fputc('\t', logFile);
+				spaces[length++] = '\t';
 			}
 			else
 			{
 				numSpaces--;
-				fputc(' ', logFile);
+				spaces[length++] = ' ';
+			}
+
+			if(length == sizeof(spaces))
+			{
+				WriteText(spaces, length);
+				length = 0;
 			}
 		}
+
+		if(length)
+			WriteText(spaces, length);
 	}
 
 	cursorPos += originalNumSpaces;
@@ -238,12 +512,7 @@ void IDebugLog::PrintSpaces(int numSpaces)
  */
 void IDebugLog::PrintText(const char * buf)
 {
-	if(logFile)
-	{
-		fputs(buf, logFile);
-		if(autoFlush)
-			fflush(logFile);
-	}
+	WriteText(buf, strlen(buf));
 
 	const char	* traverse = buf;
 	char		data;
@@ -262,12 +531,12 @@ void IDebugLog::PrintText(const char * buf)
  */
 void IDebugLog::NewLine(void)
 {
-	if(logFile)
-	{
-		fputc('\n', logFile);
+	WriteText("\n", 1);
 
-		if(autoFlush)
-			fflush(logFile);
+	if(async)
+	{
+		PushRecord(s_lineBuffer.data(), s_lineBuffer.size());
+		s_lineBuffer.clear();
 	}
 
 	cursorPos = 0;
@@ -45,6 +45,10 @@ class IDebugLog
 
 		static void			SetAutoFlush(bool inAutoFlush);
 
+		static void			SetAsync(bool inAsync);
+		static void			Flush(void);
+		static UInt32		GetDroppedCount(void);
+
 		static void			SetLogLevel(LogLevel in)	{ logLevel = in; }
 		static void			SetPrintLevel(LogLevel in)	{ printLevel = in; }
 
@@ -52,6 +56,11 @@ class IDebugLog
 		static void			PrintSpaces(int numSpaces);
 		static void			PrintText(const char * buf);
 		static void			NewLine(void);
+		static void			WriteText(const char * buf, UInt32 length);
+
+		static void			WriterThread(void);
+		static void			DrainQueue(bool waitForLock);
+		static long __stdcall	FlushLogOnCrash(struct _EXCEPTION_POINTERS * info);
 
 		static void			SeekCursor(int position);
 
@@ -62,7 +71,7 @@ class IDebugLog
 
 		static char			sourceBuf[16];		//!< name of current source, used in prefix
 		static char			headerText[16];		//!< current text to use as line prefix
-		static char			formatBuf[8192];	//!< temp buffer used for formatted messages
+		static thread_local char formatBuf[8192];	//!< temp buffer used for formatted messages, per thread
 
 		static int			indentLevel;		//!< the current indentation level (in tabs)
 		static int			rightMargin;		//!< the column at which text should be wrapped
@@ -70,6 +79,7 @@ class IDebugLog
 		static int			inBlock;			//!< are we in a block?
 
 		static bool			autoFlush;			//!< automatically flush the file after writing
+		static bool			async;				//!< lines are queued for the writer thread instead of written directly
 
 		static LogLevel		logLevel;			//!< least important log level to write
 		static LogLevel		printLevel;			//!< least important log level to print
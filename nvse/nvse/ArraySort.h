@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+struct ArrayElement;
+
+// Bottom-up merge sort. Unlike std::sort/stable_sort this stays in bounds for comparators that are not strict weak
+// orderings (user functions and the !less descending comparators). compare(later, earlier) is asked like
+// Vector::InsertSorted asks it, so equal elements end up in the same order as they did with insertion sorting.
+template <typename T, typename Compare>
+void MergeSortElements(std::vector<T>& items, Compare& compare)
+{
+	const size_t size = items.size();
+	std::vector<T> buffer(size);
+	for (size_t width = 1; width < size; width *= 2)
+	{
+		for (size_t lo = 0; lo < size; lo += 2 * width)
+		{
+			const size_t mid = std::min<size_t>(lo + width, size), hi = std::min<size_t>(lo + 2 * width, size);
+			size_t left = lo, right = mid, out = lo;
+			while (left < mid && right < hi)
+				buffer[out++] = compare(items[right], items[left]) ? items[right++] : items[left++];
+			while (left < mid)
+				buffer[out++] = items[left++];
+			while (right < hi)
+				buffer[out++] = items[right++];
+		}
+		items.swap(buffer);
+	}
+}
+
+template <typename Key>
+struct SortItem
+{
+	Key key;
+	ArrayElement* elem;
+};
+
+// compares pre-extracted keys so that names/strings aren't resolved again on every comparison
+template <typename Key, typename Less>
+struct SortKeyComparator
+{
+	Less less;
+	bool descending;
+
+	bool operator()(const SortItem<Key>& lhs, const SortItem<Key>& rhs) const
+	{
+		const bool isLT = less(lhs.key, rhs.key);
+		return descending ? !isLT : isLT;
+	}
+};
@@ -0,0 +1,176 @@
+// Standalone test and benchmark for the array sort, not part of the runtime build. Numeric, string and form keys are
+// sorted ascending and descending with MergeSortElements and with the binary insertion Vector::InsertSorted did
+// before, and both have to produce the same elements in the same order, ties included. Then both are timed.
+// Build and run it with any C++20 compiler, e.g.
+//   g++ -std=c++20 -O2 -g -fsanitize=address,undefined ArraySortTest.cpp && ./a.out
+// and without the sanitizers for timings that mean something.
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+typedef std::uint32_t UInt32;
+
+#include "ArraySort.h"
+
+#define CHECK(cond) \
+	if (!(cond)) \
+	{ \
+		std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		std::abort(); \
+	}
+
+// only identity matters here, the keys are extracted up front like ArrayVar::Sort does
+struct ArrayElement
+{
+	UInt32 index;
+};
+
+namespace
+{
+	// case insensitive like utility.cpp's
+	int StrCompare(const char* lstr, const char* rstr)
+	{
+		for (;; ++lstr, ++rstr)
+		{
+			const int lchr = std::tolower(static_cast<unsigned char>(*lstr)), rchr = std::tolower(static_cast<unsigned char>(*rstr));
+			if (lchr != rchr)
+				return lchr < rchr ? -1 : 1;
+			if (!lchr)
+				return 0;
+		}
+	}
+
+	// what Vector::InsertSorted did for every element, including the memmove of everything after the insertion point
+	template <typename T, typename Compare>
+	void InsertionSortElements(std::vector<T>& items, Compare& compare)
+	{
+		std::vector<T> sorted;
+		sorted.reserve(items.size());
+		for (const auto& item : items)
+		{
+			size_t lBound = 0, uBound = sorted.size();
+			while (lBound != uBound)
+			{
+				const size_t index = (lBound + uBound) >> 1;
+				if (compare(item, sorted[index]))
+					uBound = index;
+				else
+					lBound = index + 1;
+			}
+			sorted.insert(sorted.begin() + lBound, item);
+		}
+		items.swap(sorted);
+	}
+
+	template <typename Key, typename Less>
+	void CheckSameOrder(const std::vector<Key>& keys, std::vector<ArrayElement>& elements, Less less, bool descending)
+	{
+		std::vector<SortItem<Key>> merged, inserted;
+		for (size_t i = 0; i < keys.size(); ++i)
+			merged.push_back({ keys[i], &elements[i] });
+		inserted = merged;
+		SortKeyComparator<Key, Less> compare{ less, descending };
+		MergeSortElements(merged, compare);
+		InsertionSortElements(inserted, compare);
+		CHECK(merged.size() == inserted.size());
+		for (size_t i = 0; i < merged.size(); ++i)
+			CHECK(merged[i].elem == inserted[i].elem);
+		for (size_t i = 1; i < merged.size(); ++i)
+		{
+			const auto& prev = merged[i - 1];
+			const auto& cur = merged[i];
+			CHECK(!(descending ? less(prev.key, cur.key) : less(cur.key, prev.key)));
+			// ties keep their order ascending and are reversed descending, as with InsertSorted
+			if (!less(prev.key, cur.key) && !less(cur.key, prev.key))
+				CHECK(descending ? prev.elem->index > cur.elem->index : prev.elem->index < cur.elem->index);
+		}
+	}
+
+	const auto kNumberLess = [](double lhs, double rhs) { return lhs < rhs; };
+	const auto kFormLess = [](UInt32 lhs, UInt32 rhs) { return lhs < rhs; };
+	const auto kStringLess = [](const char* lhs, const char* rhs) { return StrCompare(lhs, rhs) < 0; };
+
+	struct Keys
+	{
+		std::vector<double> numbers;
+		std::vector<UInt32> forms;
+		std::vector<std::string> strings;
+		std::vector<const char*> stringPtrs;
+		std::vector<ArrayElement> elements;
+	};
+
+	// few distinct values so that there are plenty of ties, strings differ in case only as often as not
+	Keys MakeKeys(std::mt19937& rng, size_t size, UInt32 numDistinct)
+	{
+		Keys keys;
+		for (size_t i = 0; i < size; ++i)
+		{
+			keys.numbers.push_back(static_cast<double>(rng() % numDistinct) - numDistinct / 2.0);
+			keys.forms.push_back(0x01000000 | rng() % numDistinct);
+			auto str = "item" + std::to_string(rng() % numDistinct);
+			if (rng() % 2)
+				str[0] = 'I';
+			keys.strings.push_back(std::move(str));
+			keys.elements.push_back({ static_cast<UInt32>(i) });
+		}
+		for (const auto& str : keys.strings)
+			keys.stringPtrs.push_back(str.c_str());
+		return keys;
+	}
+
+	void TestOrder()
+	{
+		std::mt19937 rng(1);
+		for (int trial = 0; trial < 2000; ++trial)
+		{
+			const size_t size = rng() % 70;
+			auto keys = MakeKeys(rng, size, 1 + rng() % 20);
+			for (const bool descending : { false, true })
+			{
+				CheckSameOrder(keys.numbers, keys.elements, kNumberLess, descending);
+				CheckSameOrder(keys.forms, keys.elements, kFormLess, descending);
+				CheckSameOrder(keys.stringPtrs, keys.elements, kStringLess, descending);
+			}
+		}
+	}
+
+	template <typename Key, typename Less, typename Sort>
+	double TimeSort(const std::vector<Key>& keys, std::vector<ArrayElement>& elements, Less less, Sort sort)
+	{
+		std::vector<SortItem<Key>> items;
+		for (size_t i = 0; i < keys.size(); ++i)
+			items.push_back({ keys[i], &elements[i] });
+		SortKeyComparator<Key, Less> compare{ less, false };
+		const auto start = std::chrono::steady_clock::now();
+		sort(items, compare);
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	template <typename Key, typename Less>
+	void Benchmark(const char* name, const std::vector<Key>& keys, std::vector<ArrayElement>& elements, Less less)
+	{
+		const auto insertion = TimeSort(keys, elements, less, [](auto& items, auto& compare) { InsertionSortElements(items, compare); });
+		const auto merge = TimeSort(keys, elements, less, [](auto& items, auto& compare) { MergeSortElements(items, compare); });
+		std::printf("%-8s %7zu elements: insertion %9.2f ms, merge %7.2f ms\n", name, keys.size(), insertion, merge);
+	}
+}
+
+int main()
+{
+	TestOrder();
+	std::puts("array sort order matches InsertSorted");
+
+	std::mt19937 rng(2);
+	for (const size_t size : { 1000, 5000, 20000 })
+	{
+		auto keys = MakeKeys(rng, size, static_cast<UInt32>(size));
+		Benchmark("number", keys.numbers, keys.elements, kNumberLess);
+		Benchmark("form", keys.forms, keys.elements, kFormLess);
+		Benchmark("string", keys.stringPtrs, keys.elements, kStringLess);
+	}
+	return 0;
+}
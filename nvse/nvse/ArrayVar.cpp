@@ -1,5 +1,6 @@
 #include "ScriptUtils.h"
 #include "ArrayVar.h"
+#include "ArraySort.h"
 #include "GameForms.h"
 #include <algorithm>
 #include <intrin.h>
@@ -13,6 +14,8 @@
 
 ArrayVarMap g_ArrayMap;
 
+UInt32 ArrayVar::s_lastModCount = 0;
+
 ArrayData::~ArrayData()
 {
 	if ((dataType == kDataType_String) && str)
@@ -380,7 +383,7 @@ thread_local ArrayKey s_arrNumKey(kDataType_Numeric), s_arrStrKey(kDataType_Stri
 //////////////////////
 
 ArrayVar::ArrayVar(UInt32 _keyType, bool _packed, UInt8 modIndex) : m_ID(0), m_keyType(_keyType), m_bPacked(_packed),
-                                                                    m_owningModIndex(modIndex)
+                                                                    m_owningModIndex(modIndex), m_modCount(++s_lastModCount)
 {
 	if (m_keyType == kDataType_String)
 		m_elements.m_type = kContainer_StringMap;
@@ -409,6 +412,7 @@ ArrayElement* ArrayVar::Get(const ArrayKey* key, bool bCanCreateNew)
 			{
 				outElem = pArray->Append();
 				outElem->m_data.owningArray = m_ID;
+				MarkModified();
 			}
 			return outElem;
 		}
@@ -417,7 +421,10 @@ ArrayElement* ArrayVar::Get(const ArrayKey* key, bool bCanCreateNew)
 			auto* pMap = m_elements.getNumMapPtr();
 			if (bCanCreateNew)
 			{
+				UInt32 oldSize = pMap->Size();
 				ArrayElement* newElem = pMap->Emplace(key->key.num);
+				if (pMap->Size() != oldSize)
+					MarkModified();
 				newElem->m_data.owningArray = m_ID;
 				return newElem;
 			}
@@ -428,7 +435,10 @@ ArrayElement* ArrayVar::Get(const ArrayKey* key, bool bCanCreateNew)
 			auto* pMap = m_elements.getStrMapPtr();
 			if (bCanCreateNew)
 			{
+				UInt32 oldSize = pMap->Size();
 				ArrayElement* newElem = pMap->Emplace(key->key.str);
+				if (pMap->Size() != oldSize)
+					MarkModified();
 				newElem->m_data.owningArray = m_ID;
 				return newElem;
 			}
@@ -456,6 +466,7 @@ ArrayElement* ArrayVar::Get(double key, bool bCanCreateNew)
 			{
 				outElem = pArray->Append();
 				outElem->m_data.owningArray = m_ID;
+				MarkModified();
 			}
 			return outElem;
 		}
@@ -464,7 +475,10 @@ ArrayElement* ArrayVar::Get(double key, bool bCanCreateNew)
 			auto* pMap = m_elements.getNumMapPtr();
 			if (bCanCreateNew)
 			{
+				UInt32 oldSize = pMap->Size();
 				ArrayElement* newElem = pMap->Emplace(key);
+				if (pMap->Size() != oldSize)
+					MarkModified();
 				newElem->m_data.owningArray = m_ID;
 				return newElem;
 			}
@@ -481,7 +495,10 @@ ArrayElement* ArrayVar::Get(const char* key, bool bCanCreateNew)
 	auto* pMap = m_elements.getStrMapPtr();
 	if (bCanCreateNew)
 	{
+		UInt32 oldSize = pMap->Size();
 		ArrayElement* newElem = pMap->Emplace(const_cast<char*>(key));
+		if (pMap->Size() != oldSize)
+			MarkModified();
 		newElem->m_data.owningArray = m_ID;
 		return newElem;
 	}
@@ -809,7 +826,7 @@ bool ArrayVar::GetLastElement(ArrayElement** outElem, const ArrayKey** outKey)
 	return true;
 }
 
-bool ArrayVar::GetNextElement(const ArrayKey* prevKey, ArrayElement** outElem, const ArrayKey** outKey)
+bool ArrayVar::GetNextElement(const ArrayKey* prevKey, ArrayElement** outElem, const ArrayKey** outKey, UInt32* outIndex)
 {
 	if (!prevKey || Empty())
 		return false;
@@ -822,12 +839,26 @@ bool ArrayVar::GetNextElement(const ArrayKey* prevKey, ArrayElement** outElem, c
 		{
 			*outKey = iter.first();
 			*outElem = iter.second();
+			if (outIndex)
+				*outIndex = iter.Index();
 			return true;
 		}
 	}
 	return false;
 }
 
+bool ArrayVar::GetElementAt(UInt32 index, ArrayElement** outElem, const ArrayKey** outKey)
+{
+	if (index >= Size())
+		return false;
+
+	ArrayIterator iter = m_elements.begin();
+	iter += index;
+	*outKey = iter.first();
+	*outElem = iter.second();
+	return true;
+}
+
 bool ArrayVar::GetPrevElement(const ArrayKey* prevKey, ArrayElement** outElem, const ArrayKey** outKey)
 {
 	if (!prevKey || Empty())
@@ -852,19 +883,25 @@ UInt32 ArrayVar::EraseElement(const ArrayKey* key)
 {
 	if (Empty() || (KeyType() != key->KeyType()))
 		return -1;
+	MarkModified();
 	return m_elements.erase(key);
 }
 
 UInt32 ArrayVar::EraseElements(const Slice* slice)
 {
 	if (slice->bIsString || Empty()) return -1;
+	MarkModified();
 	return m_elements.erase((int)slice->m_lower, (int)slice->m_upper);
 }
 
 UInt32 ArrayVar::EraseAllElements()
 {
 	UInt32 numErased = m_elements.size();
-	if (numErased) m_elements.clear();
+	if (numErased)
+	{
+		m_elements.clear();
+		MarkModified();
+	}
 	return numErased;
 }
 
@@ -883,7 +920,10 @@ bool ArrayVar::SetSize(UInt32 newSize, const ArrayElement* padWith)
 		}
 	}
 	else if (varSize > newSize)
+	{
+		MarkModified();
 		return m_elements.erase(newSize, varSize - 1) > 0;
+	}
 
 	return true;
 }
@@ -896,6 +936,7 @@ bool ArrayVar::Insert(UInt32 atIndex, const ArrayElement* toInsert)
 	if (atIndex > varSize) return false;
 	ArrayElement* newElem = pVec->Insert(atIndex);
 	newElem->m_data.owningArray = m_ID;
+	MarkModified();
 	newElem->Set(toInsert);
 	return true;
 }
@@ -915,6 +956,7 @@ bool ArrayVar::Insert(UInt32 atIndex, ArrayID rangeID)
 	if (!srcSize) return true;
 
 	pDest->InsertSize(atIndex, srcSize);
+	MarkModified();
 	ArrayElement *pDestData = pDest->Data() + atIndex, *pSrcData = pSrc->Data();
 	for (UInt32 idx = 0; idx < srcSize; idx++)
 	{
@@ -1120,6 +1162,12 @@ public:
 	}
 };
 
+struct SortName
+{
+	const char* name; // null if the form doesn't exist or has no name
+	UInt32 formID;
+};
+
 void ArrayVar::Sort(ArrayVar* result, SortOrder order, SortType type, Script* comparator)
 {
 	// restriction: all elements of src must be of the same type
@@ -1139,45 +1187,83 @@ void ArrayVar::Sort(ArrayVar* result, SortOrder order, SortType type, Script* co
 	TempObject<ArrayElement> tempElem;
 	tempElem().m_data.owningArray = result->m_ID;
 	bool descending = (order == kSort_Descending);
+
+	const auto appendSorted = [&](ArrayElement* elem)
+	{
+		tempElem().Set(elem);
+		pOutArr->Append(tempElem());
+		tempElem().m_data.dataType = kDataType_Invalid;
+	};
+	const auto sortByKey = [&](auto extractKey, auto less)
+	{
+		using Key = decltype(extractKey(iter.second()));
+		std::vector<SortItem<Key>> items;
+		items.reserve(m_elements.size());
+		for (; !iter.End(); ++iter)
+		{
+			if (iter.second()->DataType() != dataType)
+				continue;
+			items.push_back({extractKey(iter.second()), iter.second()});
+		}
+		SortKeyComparator<Key, decltype(less)> compare{less, descending};
+		MergeSortElements(items, compare);
+		for (auto& item : items)
+			appendSorted(item.elem);
+	};
+
 	switch (type)
 	{
 	case kSortType_Default:
 		{
-			for (; !iter.End(); ++iter)
+			switch (dataType)
 			{
-				if (iter.second()->DataType() != dataType)
-					continue;
-				tempElem().Set(iter.second());
-				pOutArr->InsertSorted(tempElem(), descending);
-				tempElem().m_data.dataType = kDataType_Invalid;
+			case kDataType_Form:
+				sortByKey([](ArrayElement* elem) { return elem->m_data.formID; },
+					[](UInt32 lhs, UInt32 rhs) { return lhs < rhs; });
+				break;
+			case kDataType_String:
+				sortByKey([](ArrayElement* elem) { return static_cast<const char*>(elem->m_data.str); },
+					[](const char* lhs, const char* rhs) { return StrCompare(lhs, rhs) < 0; });
+				break;
+			default:
+				sortByKey([](ArrayElement* elem) { return elem->m_data.num; },
+					[](double lhs, double rhs) { return lhs < rhs; });
+				break;
 			}
 			break;
 		}
 	case kSortType_Alpha:
 		{
-			for (; !iter.End(); ++iter)
+			// same ordering as ArrayElement::CompareNames with each form looked up once
+			sortByKey([](ArrayElement* elem)
 			{
-				if (iter.second()->DataType() != kDataType_Form)
-					continue;
-				tempElem().SetFormID(iter.second()->m_data.formID);
-				pOutArr->InsertSorted(
-					tempElem(), descending ? ArrayElement::CompareNamesDescending : ArrayElement::CompareNames);
-				tempElem().m_data.dataType = kDataType_Invalid;
-			}
+				TESForm* form = LookupFormByID(elem->m_data.formID);
+				const char* name = form ? form->GetTheName() : nullptr;
+				return SortName{name && *name ? name : nullptr, elem->m_data.formID};
+			}, [](const SortName& lhs, const SortName& rhs)
+			{
+				if (lhs.name && rhs.name)
+					return StrCompare(lhs.name, rhs.name) < 0;
+				return lhs.formID < rhs.formID;
+			});
 			break;
 		}
 	case kSortType_UserFunction:
 		{
 			if (!comparator) break;
 			SortFunctionCaller sorter(comparator, descending);
+			std::vector<ArrayElement*> items;
+			items.reserve(m_elements.size());
 			for (; !iter.End(); ++iter)
 			{
 				if (iter.second()->DataType() != dataType)
 					continue;
-				tempElem().Set(iter.second());
-				pOutArr->InsertSorted(tempElem(), sorter);
-				tempElem().m_data.dataType = kDataType_Invalid;
+				items.push_back(iter.second());
 			}
+			const auto compare = [&](ArrayElement* lhs, ArrayElement* rhs) { return sorter(*lhs, *rhs); };
+			MergeSortElements(items, compare);
+			for (auto* elem : items)
+				appendSorted(elem);
 			break;
 		}
 	}
@@ -1861,7 +1947,116 @@ namespace PluginAPI
 		return false;
 	}
 
+	int ArrayAPI::GetContainerType(NVSEArrayVarInterface::Array* arr)
+	{
+		ArrayVar* var = g_ArrayMap.Get((ArrayID)arr);
+		if (!var)
+			return NVSEArrayVarInterface::kArrType_Invalid;
+		switch (var->GetContainerType())
+		{
+		case kContainer_Array:
+			return NVSEArrayVarInterface::kArrType_Array;
+		case kContainer_NumericMap:
+			return NVSEArrayVarInterface::kArrType_Map;
+		case kContainer_StringMap:
+			return NVSEArrayVarInterface::kArrType_StringMap;
+		default:
+			return NVSEArrayVarInterface::kArrType_Invalid;
+		}
+	}
+
+	bool ArrayAPI::ArrayHasKey(NVSEArrayVarInterface::Array* arr, const NVSEArrayVarInterface::Element& key)
+	{
+		ArrayVar* var = g_ArrayMap.Get((ArrayID)arr);
+		if (!var)
+			return false;
+		switch (key.type)
+		{
+		case key.kType_String:
+			return var->KeyType() == kDataType_String && var->HasKey(key.str);
+		case key.kType_Numeric:
+			return var->KeyType() == kDataType_Numeric && var->HasKey(key.num);
+		default:
+			return false;
+		}
+	}
+
+	NVSEArrayVarInterface::Array* ArrayAPI::CreateNumericArray(const double* values, UInt32 size, Script* callingScript)
+	{
+		ArrayID arrID;
+		ArrayElement* elements = CreatePackedElements(size, callingScript, kDataType_Numeric, &arrID);
+		if (!arrID) return NULL;
+		for (UInt32 i = 0; i < size; i++)
+			elements[i].m_data.num = values[i];
+		return (NVSEArrayVarInterface::Array*)arrID;
+	}
+
+	NVSEArrayVarInterface::Array* ArrayAPI::CreateFormArray(const UInt32* refIDs, UInt32 size, Script* callingScript)
+	{
+		ArrayID arrID;
+		ArrayElement* elements = CreatePackedElements(size, callingScript, kDataType_Form, &arrID);
+		if (!arrID) return NULL;
+		for (UInt32 i = 0; i < size; i++)
+			elements[i].m_data.formID = refIDs[i];
+		return (NVSEArrayVarInterface::Array*)arrID;
+	}
+
+	bool ArrayAPI::GetNumericArrayValues(NVSEArrayVarInterface::Array* arr, double* out, UInt32 bufferSize)
+	{
+		ElementVector* pArray = GetPackedElements(arr, bufferSize);
+		if (!pArray) return false;
+		const ArrayElement* elements = pArray->Data();
+		for (UInt32 i = 0, size = pArray->Size(); i < size; i++)
+		{
+			if (elements[i].m_data.dataType != kDataType_Numeric)
+				return false;
+			out[i] = elements[i].m_data.num;
+		}
+		return true;
+	}
+
+	bool ArrayAPI::GetFormArrayValues(NVSEArrayVarInterface::Array* arr, UInt32* out, UInt32 bufferSize)
+	{
+		ElementVector* pArray = GetPackedElements(arr, bufferSize);
+		if (!pArray) return false;
+		const ArrayElement* elements = pArray->Data();
+		for (UInt32 i = 0, size = pArray->Size(); i < size; i++)
+		{
+			if (elements[i].m_data.dataType != kDataType_Form)
+				return false;
+			out[i] = elements[i].m_data.formID;
+		}
+		return true;
+	}
+
 	// helpers
+	ArrayElement* ArrayAPI::CreatePackedElements(UInt32 size, Script* callingScript, DataType dataType, ArrayID* outID)
+	{
+		ArrayVar* arr = g_ArrayMap.Create(kDataType_Numeric, true, callingScript->GetModIndex());
+		*outID = arr ? arr->m_ID : 0;
+		if (!arr || !size) return NULL;
+		// one allocation for the whole array, the caller then fills in the values
+		ElementVector* pArray = arr->m_elements.getArrayPtr();
+		pArray->Resize(size);
+		arr->MarkModified();
+		ArrayElement* elements = pArray->Data();
+		for (UInt32 i = 0; i < size; i++)
+		{
+			elements[i].m_data.dataType = dataType;
+			elements[i].m_data.owningArray = arr->m_ID;
+		}
+		return elements;
+	}
+
+	ElementVector* ArrayAPI::GetPackedElements(NVSEArrayVarInterface::Array* arr, UInt32 bufferSize)
+	{
+		ArrayVar* var = g_ArrayMap.Get((ArrayID)arr);
+		if (!var || var->GetContainerType() != kContainer_Array || !var->IsPacked())
+			return NULL;
+		ElementVector* pArray = var->m_elements.getArrayPtr();
+		return pArray->Size() <= bufferSize ? pArray : NULL;
+	}
+
 	bool ArrayAPI::InternalElemToPluginElem(const ArrayElement* src, NVSEArrayVarInterface::Element* out)
 	{
 		switch (src->DataType())
@@ -222,6 +222,9 @@ public:
 
 		void operator++();
 		void operator--();
+		void operator+=(UInt32 count);
+
+		UInt32 Index() const {return m_iter.index;}
 
 		const ArrayKey* first();
 
@@ -253,8 +256,13 @@ class ArrayVar
 	UInt8				m_owningModIndex;
 	UInt8				m_keyType;
 	bool				m_bPacked;
+	UInt32				m_modCount;	// changes whenever keys are added or removed, element positions are stable while it doesn't
 	Vector<UInt8>		m_refs;		// data is modIndex of referring object; size() is number of references
 
+	// taken from a global counter so that a recreated array never matches a count recorded for its predecessor
+	static UInt32		s_lastModCount;
+	void MarkModified() {m_modCount = ++s_lastModCount;}
+
 public:
 	ArrayVar(UInt32 keyType, bool packed, UInt8 modIndex);
 
@@ -278,6 +286,7 @@ public:
 	UInt32 Size() const {return m_elements.size();}
 	bool Empty() const {return m_elements.empty();}
 	ContainerType GetContainerType() const {return m_elements.m_type;}
+	UInt32 ModCount() const {return m_modCount;}
 
 	ArrayElement* Get(const ArrayKey* key, bool bCanCreateNew);
 	ArrayElement* Get(double key, bool bCanCreateNew);
@@ -317,7 +326,8 @@ public:
 
 	bool GetFirstElement(ArrayElement** outElem, const ArrayKey** outKey);
 	bool GetLastElement(ArrayElement** outElem, const ArrayKey** outKey);
-	bool GetNextElement(const ArrayKey* prevKey, ArrayElement** outElem, const ArrayKey** outKey);
+	bool GetNextElement(const ArrayKey* prevKey, ArrayElement** outElem, const ArrayKey** outKey, UInt32* outIndex = NULL);
+	bool GetElementAt(UInt32 index, ArrayElement** outElem, const ArrayKey** outKey);	// by position, no key lookup
 	bool GetPrevElement(const ArrayKey* prevKey, ArrayElement** outElem, const ArrayKey** outKey);
 
 	UInt32 EraseElement(const ArrayKey* key);
@@ -392,9 +402,18 @@ namespace PluginAPI
 			NVSEArrayVarInterface::Element& out);
 		static bool GetElements(NVSEArrayVarInterface::Array* arr, NVSEArrayVarInterface::Element* elements,
 			NVSEArrayVarInterface::Element* keys);
+		static int GetContainerType(NVSEArrayVarInterface::Array* arr);
+		static bool ArrayHasKey(NVSEArrayVarInterface::Array* arr, const NVSEArrayVarInterface::Element& key);
+
+		static NVSEArrayVarInterface::Array* CreateNumericArray(const double* values, UInt32 size, Script* callingScript);
+		static NVSEArrayVarInterface::Array* CreateFormArray(const UInt32* refIDs, UInt32 size, Script* callingScript);
+		static bool GetNumericArrayValues(NVSEArrayVarInterface::Array* arr, double* out, UInt32 bufferSize);
+		static bool GetFormArrayValues(NVSEArrayVarInterface::Array* arr, UInt32* out, UInt32 bufferSize);
 
 		// helper fns
 		static bool InternalElemToPluginElem(const ArrayElement* src, NVSEArrayVarInterface::Element* out);
+		static ArrayElement* CreatePackedElements(UInt32 size, Script* callingScript, DataType dataType, ArrayID* outID);
+		static ElementVector* GetPackedElements(NVSEArrayVarInterface::Array* arr, UInt32 bufferSize);
 	};
 }
 
@@ -199,6 +199,22 @@ void ArrayVarElementContainer::iterator::operator++()
 	}
 }
 
+void ArrayVarElementContainer::iterator::operator+=(UInt32 count)
+{
+	switch (m_type)
+	{
+		case kContainer_Array:
+			AsArray().operator+=(count);
+			break;
+		case kContainer_NumericMap:
+			AsNumMap().operator+=(count);
+			break;
+		case kContainer_StringMap:
+			AsStrMap().operator+=(count);
+			break;
+	}
+}
+
 void ArrayVarElementContainer::iterator::operator--()
 {
 	switch (m_type)
@@ -0,0 +1,149 @@
+// Standalone microbenchmark for the per Call site cache in FunctionScripts.cpp, not part of the runtime build.
+// Resolving the script and FunctionInfo of a call used to take DYNAMIC_CAST(form, TESForm, Script) plus
+// UserFunctionManager::GetFunctionInfo (direct-mapped slots in front of m_functionInfos) on every call. A call site
+// now looks itself up by the address of its script expression and only does that again when the form changed.
+// The game's RTTI cast and the JIP containers don't build outside the game, so the stand-ins are C++ dynamic_cast
+// over the same TESForm -> Script hierarchy and std::unordered_map for UnorderedMap. Both paths use the same
+// stand-ins, so the difference between them is what the cache saves or costs. Build and run it with e.g.
+//   g++ -std=c++20 -O2 CallSiteCacheBenchmark.cpp && ./a.out
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	struct BaseFormComponent
+	{
+		virtual ~BaseFormComponent() = default;
+	};
+
+	struct TESForm : BaseFormComponent
+	{
+		std::uint32_t refID = 0;
+	};
+
+	struct Script : TESForm
+	{
+		void* data = nullptr;
+	};
+
+	struct FunctionInfo
+	{
+		Script* script;
+		bool bad = false;
+
+		bool IsGood() const { return !bad; }
+	};
+
+	// the lookup that GetFunctionInfo does
+	class FunctionInfos
+	{
+		enum { kNumInfoSlots = 0x40 };
+
+		struct FunctionInfoSlot
+		{
+			Script* script = nullptr;
+			FunctionInfo* info = nullptr;
+		};
+
+		std::unordered_map<Script*, FunctionInfo> m_functionInfos;
+		FunctionInfoSlot m_infoSlots[kNumInfoSlots];
+
+	public:
+		FunctionInfo* Get(Script* funcScript)
+		{
+			auto& slot = m_infoSlots[(reinterpret_cast<std::uintptr_t>(funcScript) >> 4) & (kNumInfoSlots - 1)];
+			if (slot.script != funcScript)
+			{
+				slot.script = funcScript;
+				slot.info = &m_functionInfos.try_emplace(funcScript, FunctionInfo{ funcScript }).first->second;
+			}
+			return slot.info->IsGood() ? slot.info : nullptr;
+		}
+	};
+
+	struct UserFunctionCallSite
+	{
+		TESForm* form = nullptr;
+		Script* script = nullptr;
+		FunctionInfo* info = nullptr;
+	};
+
+	struct Call
+	{
+		std::uint8_t* callSiteKey;
+		TESForm* form;
+	};
+
+	FunctionInfo* ResolveUncached(FunctionInfos& infos, const Call& call)
+	{
+		auto* script = dynamic_cast<Script*>(call.form);
+		return script ? infos.Get(script) : nullptr;
+	}
+
+	FunctionInfo* ResolveCached(FunctionInfos& infos, std::unordered_map<std::uint8_t*, UserFunctionCallSite>& callSites, const Call& call)
+	{
+		auto& callSite = callSites[call.callSiteKey];
+		if (call.form && callSite.form == call.form && callSite.info)
+			return callSite.info;
+		callSite.form = call.form;
+		callSite.script = dynamic_cast<Script*>(call.form);
+		callSite.info = callSite.script ? infos.Get(callSite.script) : nullptr;
+		return callSite.info;
+	}
+
+	template <typename F>
+	double NanosecondsPerCall(const std::vector<Call>& calls, F&& resolve)
+	{
+		std::uintptr_t sink = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (const auto& call : calls)
+			sink += reinterpret_cast<std::uintptr_t>(resolve(call));
+		const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		// keeps the loop from being optimized away
+		if (sink == 1)
+			std::puts("");
+		return elapsed / calls.size();
+	}
+
+	// every call site calls one script (a Call with a fixed UDF) or, if polymorphic, alternates between two (a Call on a
+	// ref variable that changes each time, which misses the cache every time)
+	void Run(const char* name, bool polymorphic)
+	{
+		constexpr int kNumScripts = 50, kNumCallSites = 300, kNumCalls = 5000000;
+		std::vector<Script> scripts(kNumScripts);
+		std::vector<std::uint8_t> bytecode(kNumCallSites * 16);
+		std::mt19937 rng(1);
+		std::vector<std::pair<TESForm*, TESForm*>> formsBySite;
+		for (int i = 0; i < kNumCallSites; ++i)
+			formsBySite.emplace_back(&scripts[rng() % kNumScripts], &scripts[rng() % kNumScripts]);
+		std::vector<Call> calls;
+		for (int i = 0; i < kNumCalls; ++i)
+		{
+			const auto site = rng() % kNumCallSites;
+			const auto& [form, otherForm] = formsBySite[site];
+			calls.push_back({ &bytecode[site * 16], polymorphic && i % 2 ? otherForm : form });
+		}
+
+		FunctionInfos uncachedInfos, cachedInfos;
+		std::unordered_map<std::uint8_t*, UserFunctionCallSite> callSites;
+		// first pass warms up both
+		for (int pass = 0; pass < 3; ++pass)
+		{
+			const auto uncached = NanosecondsPerCall(calls, [&](const Call& call) { return ResolveUncached(uncachedInfos, call); });
+			const auto cached = NanosecondsPerCall(calls, [&](const Call& call) { return ResolveCached(cachedInfos, callSites, call); });
+			if (pass)
+				std::printf("%-12s cast + GetFunctionInfo %6.2f ns/call, call site cache %6.2f ns/call\n", name, uncached, cached);
+		}
+	}
+}
+
+int main()
+{
+	Run("monomorphic", false);
+	Run("polymorphic", true);
+	return 0;
+}
@@ -2,6 +2,9 @@
 #include "ScriptTokens.h"
 #include "ThreadLocal.h"
 #include "GameRTTI.h"
+#include "ScriptTokenCache.h"
+#include "Commands_Scripting.h"
+#include "Utilities.h"
 
 /*******************************************
 	UserFunctionManager
@@ -9,7 +12,7 @@
 
 UserFunctionManager::UserFunctionManager() : m_nestDepth(0)
 {
-	//
+	memset(m_infoSlots, 0, sizeof(m_infoSlots));
 }
 
 UserFunctionManager::~UserFunctionManager()
@@ -21,7 +24,9 @@ UserFunctionManager::~UserFunctionManager()
 	}
 }
 
-static SmallObjectsAllocator::LockBasedAllocator<FunctionContext, 5> g_functionContextAllocator;
+// contexts are created and destroyed by the UserFunctionManager of the calling thread, so no lock is needed;
+// one block covers the max nest depth
+static thread_local SmallObjectsAllocator::FastAllocator<FunctionContext, 32> g_functionContextAllocator;
 
 void* FunctionContext::operator new(size_t size)
 {
@@ -72,10 +77,39 @@ bool UserFunctionManager::Pop(Script* funcScript)
 	return false;
 }
 
+// monomorphic inline cache of a Call statement, keyed by the position of its script expression. A site whose script
+// changes between calls misses every time and pays for the lookup on top, see CallSiteCacheBenchmark.cpp
+struct UserFunctionCallSite
+{
+	TESForm			* form = NULL;	// last form the script expression evaluated to
+	Script			* script = NULL;
+	FunctionInfo	* info = NULL;	// owned by the thread's UserFunctionManager, entries never move
+};
+
+// cleared along with TokenCache like DefaultArgPlanCache
+class UserFunctionCallSiteCache
+{
+	UnorderedMap<UInt8*, UserFunctionCallSite> cache_;
+	int clearToken_ = 0;
+public:
+	UserFunctionCallSite& Get(UInt8* key)
+	{
+		const int cookie = TokenCache::GetClearCookie();
+		if (clearToken_ != cookie)
+		{
+			clearToken_ = cookie;
+			cache_.Clear();
+		}
+		return cache_[key];
+	}
+};
+
+static thread_local UserFunctionCallSiteCache g_userFunctionCallSites;
+
 class ScriptFunctionCaller : public FunctionCaller
 {
 public:
-	ScriptFunctionCaller(ExpressionEvaluator & context) : m_eval(context), m_callerVersion(-1), m_funcScript(NULL)
+	ScriptFunctionCaller(ExpressionEvaluator & context) : m_eval(context), m_callerVersion(-1), m_funcScript(NULL), m_callSite(NULL)
 		{ }
 	virtual ~ScriptFunctionCaller() { }
 
@@ -89,11 +123,13 @@ public:
 			return m_funcScript;
 
 		ScriptToken* scrToken = NULL;
+		UInt8* callSiteKey = NULL;
 		switch (m_callerVersion) {
 			case 0: 
 				scrToken = ScriptToken::Read(&m_eval);
 				break;
 			case 1:
+				callSiteKey = m_eval.Data();
 				scrToken = m_eval.Evaluate();
 				break;
 			default:
@@ -102,7 +138,22 @@ public:
 		}
 
 		if (scrToken) {
-			m_funcScript = DYNAMIC_CAST(scrToken->GetTESForm(), TESForm, Script);
+			// looked up after evaluating, calls made by the expression may add sites of their own
+			if (callSiteKey)
+				m_callSite = &g_userFunctionCallSites.Get(callSiteKey);
+			TESForm* form = scrToken->GetTESForm();
+			if (m_callSite && form && m_callSite->form == form)
+				m_funcScript = m_callSite->script;
+			else
+			{
+				m_funcScript = DYNAMIC_CAST(form, TESForm, Script);
+				if (m_callSite)
+				{
+					m_callSite->form = form;
+					m_callSite->script = m_funcScript;
+					m_callSite->info = NULL;
+				}
+			}
 			if (!scrToken->cached)
 			{
 				delete scrToken;
@@ -112,6 +163,18 @@ public:
 		return m_funcScript;
 	}
 
+	virtual FunctionInfo* GetCachedInfo() {
+		// a recompiled script goes back through GetFunctionInfo() to be reparsed
+		if (m_callSite && m_callSite->info && m_callSite->info->IsGood() && !m_callSite->info->IsStale())
+			return m_callSite->info;
+		return NULL;
+	}
+
+	virtual void SetCachedInfo(FunctionInfo* info) {
+		if (m_callSite)
+			m_callSite->info = info;
+	}
+
 	virtual bool PopulateArgs(ScriptEventList* eventList, FunctionInfo* info) {
 		m_eval.SetParams(info->Params());
 		if (!m_eval.ExtractArgs())
@@ -129,7 +192,7 @@ public:
 				return false;
 			}
 
-			ScriptEventList::Var* var = eventList->GetVariable(param->varIdx);
+			ScriptEventList::Var* var = info->GetParamVar(eventList, i);
 			if (!var)
 			{
 				ShowRuntimeError(info->GetScript(), "Param variable not found. Function definition may be out of sync with function call. Recomplie the scripts and try again.");
@@ -171,6 +234,7 @@ private:
 	ExpressionEvaluator&	m_eval;
 	UInt8					m_callerVersion;
 	Script					* m_funcScript;
+	UserFunctionCallSite	* m_callSite;
 };
 
 ScriptToken* UserFunctionManager::Call(ExpressionEvaluator* eval)
@@ -199,13 +263,22 @@ ScriptToken* UserFunctionManager::Call(FunctionCaller & caller)
 	}
 
 	// get function info for script
-	FunctionInfo* info = funcMan->GetFunctionInfo(funcScript);
+	FunctionInfo* info = caller.GetCachedInfo();
 	if (!info)
 	{
-		ShowRuntimeError(funcScript, "Could not parse function info for function script");
-		return NULL;
+		info = funcMan->GetFunctionInfo(funcScript);
+		if (!info)
+		{
+			ShowRuntimeError(funcScript, "Could not parse function info for function script");
+			return NULL;
+		}
+		caller.SetCachedInfo(info);
 	}
 
+	// a trivial function can't call anything, so it neither nests nor needs a context
+	if (info->IsInlinable() && !info->IsActive() && callerVersion <= 1)
+		return info->EvaluateInline(caller);
+
 	// create a function context for execution
 	FunctionContext* context = info->CreateContext(callerVersion, caller.GetInvokingScript());
 	if (!context)
@@ -219,8 +292,9 @@ ScriptToken* UserFunctionManager::Call(FunctionCaller & caller)
 	funcMan->Push(context);
 
 	funcMan->m_nestDepth++;
-	if (info->Execute(caller, context) && funcMan->Top(funcScript) && context->Result())
-		funcResult = context->Result()->ToBasicToken();
+	// Return() already stored a basic token
+	if (info->Execute(caller, context) && funcMan->Top(funcScript))
+		funcResult = context->TakeResult();
 
 	funcMan->m_nestDepth--;
 
@@ -248,7 +322,15 @@ bool UserFunctionManager::Return(ExpressionEvaluator* eval)
 
 FunctionInfo* UserFunctionManager::GetFunctionInfo(Script* funcScript)
 {
-	FunctionInfo *funcInfo = m_functionInfos.Emplace(funcScript, funcScript);
+	FunctionInfoSlot& slot = m_infoSlots[(reinterpret_cast<UInt32>(funcScript) >> 4) & (kNumInfoSlots - 1)];
+	if (slot.script != funcScript)
+	{
+		slot.script = funcScript;
+		slot.info = m_functionInfos.Emplace(funcScript, funcScript);
+	}
+	FunctionInfo *funcInfo = slot.info;
+	if (funcInfo->IsStale())
+		funcInfo->Reload();
 	return (funcInfo->IsGood()) ? funcInfo : NULL;
 }
 	
@@ -273,8 +355,89 @@ Script* UserFunctionManager::GetInvokingScript(Script* fnScript)
 	FunctionInfo
 *****************************/
 
+// opt-in through [RELEASE] InlineTrivialFunctions=1 in nvse_config.ini
+static bool IsFunctionInliningEnabled()
+{
+	static const bool s_enabled = []
+	{
+		UInt32 enabled = 0;
+		return GetNVSEConfigOption_UInt32("RELEASE", "InlineTrivialFunctions", &enabled) && enabled;
+	}();
+	return s_enabled;
+}
+
+// a body of nothing but 'SetFunctionValue <expr>' whose expression only reads literals and the function's own
+// variables has no side effects, so its value can be taken without running the script. Commands, refs, globals,
+// other forms' variables and assignments all disqualify it. Returns the offset of the SetFunctionValue args or 0.
+static UInt32 FindInlineExpression(Script* script, UInt8* data)
+{
+	UInt8* scriptData = (UInt8*)script->data;
+	UInt8* endData = scriptData + script->info.dataLength;
+	if (data + 4 > endData)
+		return 0;
+
+	CommandInfo* cmd = g_scriptCommands.GetByOpcode(*((UInt16*)data));
+	if (!cmd || cmd->execute != kCommandInfo_SetFunctionValue.execute)
+		return 0;
+
+	UInt8* args = data + 4;
+	UInt8* endArgs = args + *((UInt16*)(data + 2));
+	// the block has to end right after it
+	if (endArgs + 4 > endData || *((UInt16*)endArgs) != 0x11)
+		return 0;
+
+	// a single expression: numArgs, then its length including the length itself
+	if (endArgs - args < 3 || *args != 1 || args + 1 + *((UInt16*)(args + 1)) != endArgs)
+		return 0;
+
+	UInt8* pos = args + 3;
+	while (pos < endArgs)
+	{
+		switch (*pos++)
+		{
+		case 'B':
+		case 'b':
+			pos += 1;
+			break;
+		case 'I':
+		case 'i':
+			pos += 2;
+			break;
+		case 'L':
+		case 'l':
+			pos += 4;
+			break;
+		case 'Z':
+			pos += sizeof(double);
+			break;
+		case 'S':
+			pos += 2 + *((UInt16*)pos);
+			break;
+		case 'V':
+			// varType, refIdx, varIdx; a refIdx means another form's variable
+			if (*((UInt16*)(pos + 1)))
+				return 0;
+			pos += 5;
+			break;
+		case kOpType_Assignment:
+		case kOpType_PlusEquals:
+		case kOpType_TimesEquals:
+		case kOpType_DividedEquals:
+		case kOpType_ExponentEquals:
+		case kOpType_MinusEquals:
+			return 0;
+		default:
+			if (pos[-1] >= kOpType_Max)
+				return 0;
+			break;
+		}
+	}
+
+	return (pos == endArgs) ? args - scriptData : 0;
+}
+
 FunctionInfo::FunctionInfo(Script* script)
-: m_script(script), m_destructibles(NULL), m_numDestructibles(0), m_functionVersion(-1), m_bad(0), m_instanceCount(0), m_eventList(NULL)
+: m_script(script), m_scriptData(script ? script->data : NULL), m_destructibles(NULL), m_numDestructibles(0), m_functionVersion(-1), m_bad(0), m_instanceCount(0), m_inlineOffset(0), m_eventList(NULL)
 {
 	if (!script || !script->data)
 		return;
@@ -344,6 +507,21 @@ FunctionInfo::FunctionInfo(Script* script)
 
 	// successfully constructed
 	m_bad = (NULL == m_eventList);
+	if (m_bad)
+		return;
+
+	// the cached event list is only reset between calls, so its vars can be looked up once
+	m_paramVars.resize(numParams);
+	for (UInt32 i = 0; i < numParams; i++)
+		m_paramVars[i] = m_eventList->GetVariable(params[i].varIdx);
+
+	m_destructibleVars.resize(m_numDestructibles);
+	for (UInt32 i = 0; i < m_numDestructibles; i++)
+		m_destructibleVars[i] = m_eventList->GetVariable(m_destructibles[i]);
+
+	// reparsed along with everything else when the script is recompiled, see Reload()
+	if (IsFunctionInliningEnabled())
+		m_inlineOffset = FindInlineExpression(script, data);
 }
 
 FunctionInfo::~FunctionInfo()
@@ -352,6 +530,40 @@ FunctionInfo::~FunctionInfo()
 		delete[] m_destructibles;
 
 	GameHeapFree(m_eventList);
+
+	for (ScriptEventList* eventList : m_spareEventLists)
+	{
+		eventList->Destructor();
+		FormHeap_Free(eventList);
+	}
+}
+
+void FunctionInfo::Reload()
+{
+	// contexts on the stack still point to this info, pick up the new data once they have returned
+	if (IsActive())
+		return;
+
+	Script* script = m_script;
+	this->~FunctionInfo();
+	new (this) FunctionInfo(script);
+}
+
+ScriptEventList* FunctionInfo::AcquireRecursionEventList()
+{
+	if (m_spareEventLists.empty())
+		return m_script->CreateEventList();
+
+	ScriptEventList* eventList = m_spareEventLists.back();
+	m_spareEventLists.pop_back();
+	return eventList;
+}
+
+void FunctionInfo::ReleaseRecursionEventList(ScriptEventList* eventList)
+{
+	// same reset as the cached event list gets after a call, nesting depth bounds how many are kept
+	eventList->ResetAllVariables();
+	m_spareEventLists.push_back(eventList);
 }
 
 FunctionContext* FunctionInfo::CreateContext(UInt8 version, Script* invokingScript)
@@ -377,6 +589,14 @@ UserFunctionParam* FunctionInfo::GetParam(UInt32 paramIndex)
 	return &m_userFunctionParams[paramIndex];
 }
 
+ScriptEventList::Var* FunctionInfo::GetParamVar(ScriptEventList* eventList, UInt32 paramIndex)
+{
+	if (eventList == m_eventList && paramIndex < m_paramVars.size())
+		return m_paramVars[paramIndex];
+
+	return eventList->GetVariable(m_userFunctionParams[paramIndex].varIdx);
+}
+
 UInt32 FunctionInfo::GetParamVarTypes(UInt8* out) const
 {
 	UInt32 count = m_userFunctionParams.size();
@@ -391,9 +611,10 @@ UInt32 FunctionInfo::GetParamVarTypes(UInt8* out) const
 
 bool FunctionInfo::CleanEventList(ScriptEventList* eventList)
 {
+	const bool isCachedList = (eventList == m_eventList);
 	for (UInt32 i = 0; i < m_numDestructibles; i++)
 	{
-		ScriptEventList::Var* var = eventList->GetVariable(m_destructibles[i]);
+		ScriptEventList::Var* var = isCachedList ? m_destructibleVars[i] : eventList->GetVariable(m_destructibles[i]);
 		if (!var)
 			return false;
 
@@ -414,6 +635,29 @@ bool FunctionInfo::Execute(FunctionCaller& caller, FunctionContext* context)
 	return bResult;
 }
 
+ScriptToken* FunctionInfo::EvaluateInline(FunctionCaller& caller)
+{
+	// same steps as FunctionContext::Execute() and Return(), minus the script
+	ScriptToken* result = NULL;
+	if (caller.PopulateArgs(m_eventList, this))
+	{
+		UInt32 opcodeOffset = m_inlineOffset;
+		double unusedResult = 0;
+		ExpressionEvaluator eval(kCommandInfo_SetFunctionValue.params, m_script->data, caller.ThisObj(), caller.ContainingObj(),
+			m_script, m_eventList, &unusedResult, &opcodeOffset);
+		if (eval.ExtractArgs() && eval.NumArgs() == 1)
+			result = eval.Arg(0)->ToBasicToken();
+		else
+			ShowRuntimeError(m_script, "SetFunctionValue statement failed.");
+
+		if (!CleanEventList(m_eventList))
+			ShowRuntimeError(m_script, "Couldn't clean event list after function call.");
+	}
+
+	m_eventList->ResetAllVariables();
+	return result;
+}
+
 /******************************
 	FunctionContext
 ******************************/
@@ -436,7 +680,7 @@ m_invokingScript(invokingScript), m_callerVersion(version), m_bad(true), m_resul
 	}
 
 	if (info->IsActive()) {
-		m_eventList = info->GetScript()->CreateEventList();
+		m_eventList = info->AcquireRecursionEventList();
 	}
 	else {
 		m_eventList = info->GetEventList();
@@ -466,8 +710,7 @@ FunctionContext::~FunctionContext()
 	if (m_eventList)
 	{
 		if (m_eventList != m_info->GetEventList()) {
-			m_eventList->Destructor();
-			FormHeap_Free(m_eventList);
+			m_info->ReleaseRecursionEventList(m_eventList);
 		}
 		else {
 			m_eventList->ResetAllVariables();
@@ -532,7 +775,7 @@ bool InternalFunctionCaller::PopulateArgs(ScriptEventList* eventList, FunctionIn
 			return false;
 		}
 
-		ScriptEventList::Var* var = eventList->GetVariable(param->varIdx);
+		ScriptEventList::Var* var = info->GetParamVar(eventList, i);
 		if (!var) {
 			ShowRuntimeError(m_script, "Could not look up argument variable for function script");
 			return false;
@@ -26,6 +26,9 @@ public:
 	virtual UInt8 ReadCallerVersion() = 0;
 	virtual Script * ReadScript() = 0;
 	virtual bool PopulateArgs(ScriptEventList* eventList, FunctionInfo* info) = 0;
+	// info remembered by the caller for the script returned by ReadScript(), if any
+	virtual FunctionInfo* GetCachedInfo() { return NULL; }
+	virtual void SetCachedInfo(FunctionInfo* info) { }
 
 	virtual TESObjectREFR* ThisObj() = 0;
 	virtual TESObjectREFR* ContainingObj() = 0;
@@ -39,12 +42,17 @@ private:
 	DynamicParamInfo	m_dParamInfo;
 	std::vector<UserFunctionParam> m_userFunctionParams;
 	Script				* m_script;			// function script
+	void				* m_scriptData;		// script->data this info was parsed from, replaced when the script is recompiled
 	UInt16				* m_destructibles;	// dynamic array of var indexes of local array vars to be destroyed on function return
 	UInt8				m_numDestructibles;
 	UInt8				m_functionVersion;	// bytecode version of Function statement
 	bool				m_bad;
 	UInt8				m_instanceCount;
+	UInt32				m_inlineOffset;		// offset of the SetFunctionValue args if the function is trivial enough to be evaluated in place, else 0
 	ScriptEventList		* m_eventList;		// cached for quicker construction of function script, but requires care when dealing with recursive function calls
+	std::vector<ScriptEventList*> m_spareEventLists;	// reset event lists left over from recursive calls, reused by the next ones
+	std::vector<ScriptEventList::Var*> m_paramVars;			// param vars of m_eventList, which keeps its vars across calls
+	std::vector<ScriptEventList::Var*> m_destructibleVars;	// likewise for m_destructibles
 
 public:
 	FunctionInfo() {}
@@ -54,13 +62,20 @@ public:
 	FunctionContext	* CreateContext(UInt8 version, Script* invokingScript);
 	bool IsGood() { return !m_bad; }
 	bool IsActive() { return m_instanceCount ? true : false; }
+	bool IsStale() { return m_script && m_script->data != m_scriptData; }
+	bool IsInlinable() { return m_inlineOffset != 0; }
+	void Reload();
 	Script* GetScript() { return m_script; }
 	ParamInfo* Params() { return m_dParamInfo.Params(); }
 	DynamicParamInfo& ParamInfo() { return m_dParamInfo; }
 	UserFunctionParam* GetParam(UInt32 paramIndex);
+	ScriptEventList::Var* GetParamVar(ScriptEventList* eventList, UInt32 paramIndex);
 	bool CleanEventList(ScriptEventList* eventList);
 	bool Execute(FunctionCaller& caller, FunctionContext* context);
+	ScriptToken* EvaluateInline(FunctionCaller& caller);	// for inlinable functions, returns the value without running the script
 	ScriptEventList* GetEventList() { return m_eventList; }
+	ScriptEventList* AcquireRecursionEventList();
+	void ReleaseRecursionEventList(ScriptEventList* eventList);
 	UInt32 GetParamVarTypes(UInt8* out) const;	// returns count, if > 0 returns types as array
 };
 
@@ -82,6 +97,7 @@ public:
 	bool Return(ExpressionEvaluator* eval);
 	bool IsGood() { return !m_bad; }
 	ScriptToken*  Result() { return m_result; }
+	ScriptToken*  TakeResult() { ScriptToken* result = m_result; m_result = NULL; return result; }
 	FunctionInfo* Info() { return m_info; }
 	Script* InvokingScript() { return m_invokingScript; }
 	void* operator new(size_t size);
@@ -98,10 +114,19 @@ class UserFunctionManager
 	UserFunctionManager();
 
 	static const UInt32	kMaxNestDepth = 30;	// arbitrarily low; have seen 180+ nested calls execute w/o problems
-	
+	enum { kNumInfoSlots = 0x40 };	// power of 2
+
+	// direct-mapped in front of m_functionInfos, whose entries never move
+	struct FunctionInfoSlot
+	{
+		Script			* script;
+		FunctionInfo	* info;
+	};
+
 	UInt32								m_nestDepth;
 	Stack<FunctionContext*>		m_functionStack; // I'd put 1 but you just know there's someone who loves recursion enough to do it in obscript -Korma
 	UnorderedMap<Script*, FunctionInfo>	m_functionInfos;
+	FunctionInfoSlot					m_infoSlots[kNumInfoSlots];
 
 	// these take a ptr to the function script to check that it matches executing script
 	FunctionContext* Top(Script* funcScript);
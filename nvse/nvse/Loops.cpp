@@ -17,7 +17,8 @@ LoopManager* LoopManager::GetSingleton()
 	return localData.loopManager;
 }
 
-ArrayIterLoop::ArrayIterLoop(const ForEachContext* context, UInt8 modIndex)
+ArrayIterLoop::ArrayIterLoop(const ForEachContext* context, UInt8 modIndex) : m_srcModCount(0), m_curIndex(0),
+	m_iterModCount(0), m_keySlot(NULL), m_valueSlot(NULL)
 {
 	m_srcID = context->sourceID;
 	m_iterID = context->iteratorID;
@@ -35,6 +36,7 @@ ArrayIterLoop::ArrayIterLoop(const ForEachContext* context, UInt8 modIndex)
 		if (arr->GetFirstElement(&elem, &key))
 		{
 			m_curKey = *key;
+			m_srcModCount = arr->ModCount();
 			UpdateIterator(elem);		// initialize iterator to first element in array
 		}
 	}
@@ -45,17 +47,25 @@ void ArrayIterLoop::UpdateIterator(const ArrayElement* elem)
 	ArrayVar *arr = g_ArrayMap.Get(m_iterID);
 	if (!arr) return;
 
+	if (arr->ModCount() != m_iterModCount)
+	{
+		// create both slots first, adding the second one can move the first
+		arr->Get("key", true);
+		arr->Get("value", true);
+		m_keySlot = arr->Get("key", false);
+		m_valueSlot = arr->Get("value", false);
+		m_iterModCount = arr->ModCount();
+	}
+
 	// iter["key"] = element key
-	ArrayElement *newElem = arr->Get("key", true);
-	if (newElem)
+	if (m_keySlot)
 	{
 		if (m_curKey.KeyType() == kDataType_String)
-			newElem->SetString(m_curKey.key.str);
-		else newElem->SetNumber(m_curKey.key.num);
+			m_keySlot->SetString(m_curKey.key.str);
+		else m_keySlot->SetNumber(m_curKey.key.num);
 	}
 	// iter["value"] = element data
-	newElem = arr->Get("value", true);
-	if (newElem) newElem->Set(elem);
+	if (m_valueSlot) m_valueSlot->Set(elem);
 }
 
 bool ArrayIterLoop::Update(COMMAND_ARGS)
@@ -65,7 +75,16 @@ bool ArrayIterLoop::Update(COMMAND_ARGS)
 	{
 		ArrayElement *elem;
 		const ArrayKey *key;
-		if (arr->GetNextElement(&m_curKey, &elem, &key))
+		bool found;
+		if (arr->ModCount() == m_srcModCount)
+			found = arr->GetElementAt(++m_curIndex, &elem, &key);
+		else
+		{
+			// array was modified by the loop body, resume after the last key
+			found = arr->GetNextElement(&m_curKey, &elem, &key, &m_curIndex);
+			m_srcModCount = arr->ModCount();
+		}
+		if (found)
 		{
 			m_curKey = *key;
 			UpdateIterator(elem);	
@@ -87,11 +106,12 @@ StringIterLoop::StringIterLoop(const ForEachContext* context)
 	StringVar* iterVar = g_StringMap.Get(context->iteratorID);
 	if (srcVar && iterVar)
 	{
-		m_src = srcVar->String();
+		// copied once, the loop iterates a snapshot even if the source is modified in its body
+		m_src = srcVar->View();
 		m_curIndex = 0;
 		m_iterID = context->iteratorID;
 		if (m_src.length())
-			iterVar->Set(m_src.substr(0, 1).c_str());
+			iterVar->Set(std::string_view(m_src).substr(0, 1));
 	}
 }
 
@@ -103,7 +123,7 @@ bool StringIterLoop::Update(COMMAND_ARGS)
 		m_curIndex++;
 		if (m_curIndex < m_src.length())
 		{
-			iterVar->Set(m_src.substr(m_curIndex, 1).c_str());
+			iterVar->Set(std::string_view(m_src).substr(m_curIndex, 1));
 			return true;
 		}
 	}
@@ -55,6 +55,15 @@ class ArrayIterLoop : public ForEachLoop
 	ArrayKey				m_curKey;
 	ScriptEventList::Var	*m_iterVar;
 
+	// positional cursor, only valid while the source array's mod count is unchanged
+	UInt32					m_srcModCount;
+	UInt32					m_curIndex;
+
+	// cached iter["key"] and iter["value"] slots
+	UInt32					m_iterModCount;
+	ArrayElement			*m_keySlot;
+	ArrayElement			*m_valueSlot;
+
 	void UpdateIterator(const ArrayElement* elem);
 public:
 	ArrayIterLoop(const ForEachContext* context, UInt8 modIndex);
@@ -166,6 +166,10 @@ struct NVSEIOInterface
  *	all plugins have been loaded, at which point it is safe to establish communications between
  *	plugins.
  *
+ *	Listeners that only care about a few message types (e.g. not kMessage_MainGameLoop, which is
+ *	sent every frame) can use RegisterListenerForMessages() with a mask of the wanted types instead;
+ *	they are then not called at all for the others.
+ *
  *	Some plugin authors may wish to use strings instead of integers to denote message type. In
  *	that case the receiver can pass the address of the string as an integer and require the receiver
  *	to cast it back to a char* on receipt.
@@ -184,7 +188,7 @@ struct NVSEMessagingInterface
 	typedef void (*EventCallback)(Message* msg);
 
 	enum {
-		kVersion = 4
+		kVersion = 5
 	};
 
 	// NVSE messages
@@ -251,6 +255,11 @@ kMessage_PostQueryPlugins // called after all plugins have been queried
 	UInt32	version;
 	bool	(*RegisterListener)(PluginHandle listener, const char* sender, EventCallback handler);
 	bool	(*Dispatch)(PluginHandle sender, UInt32 messageType, void* data, UInt32 dataLen, const char* receiver);
+
+	// version 5
+	// Like RegisterListener, but only message types whose bit is set in messageMask (1 << type) are delivered;
+	// types above 31 are always delivered. Calling it again for the same sender replaces the mask.
+	bool	(*RegisterListenerForMessages)(PluginHandle listener, const char* sender, EventCallback handler, UInt32 messageMask);
 };
 
 /**** array_var API **************************************************************************
@@ -310,6 +319,9 @@ kMessage_PostQueryPlugins // called after all plugins have been queried
 *	 array is a Map-type and the 'keys' argument is non-null, 'keys' will contain the keys
 *	 associated with each element. Both 'keys' and 'elements' must be of a size large enough
 *	 to hold all of the array data; use GetArraySize() to determine the size.
+*	-Use CreateNumericArray() / CreateFormArray() to build an Array-type array straight from a
+*	 C array of doubles or form IDs, and GetNumericArrayValues() / GetFormArrayValues() to read
+*	 one back into a caller-supplied buffer. These avoid building an Element per value.
 *	-Use LookupArrayByID to attempt to get an Array* given its unique integer ID. This allows
 *	 plugin commands to accept arrays as arguments by defining the parameter as an integer.
 *	 See the nvse_plugin_example project for sample usage. Or, better, see below for info
@@ -328,7 +340,7 @@ kMessage_PostQueryPlugins // called after all plugins have been queried
 struct NVSEArrayVarInterface
 {
 	enum {
-		kVersion = 2
+		kVersion = 3
 	};
 
 	struct Array;
@@ -536,6 +548,17 @@ struct NVSEArrayVarInterface
 
 	int		(*GetContainerType)(Array* arr);
 	bool	(*ArrayHasKey)(Array* arr, const Element& key);
+
+	// version 3
+	// Typed bulk operations, these skip the per-Element conversion done by CreateArray/GetElements.
+	// The Create functions make a packed Array-type array holding size elements in a single allocation.
+	Array* (*CreateNumericArray)(const double* values, UInt32 size, Script* callingScript);
+	Array* (*CreateFormArray)(const UInt32* refIDs, UInt32 size, Script* callingScript);
+	// Copy a packed Array-type array into out. Returns false (leaving the buffer in an unspecified state) if the array
+	// does not exist, is not packed, holds more than bufferSize elements or holds an element of another type.
+	// Use GetArraySize() to size the buffer.
+	bool	(*GetNumericArrayValues)(Array* arr, double* out, UInt32 bufferSize);
+	bool	(*GetFormArrayValues)(Array* arr, UInt32* out, UInt32 bufferSize);
 };
 
 #endif
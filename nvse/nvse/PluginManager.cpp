@@ -25,6 +25,10 @@ PluginManager	g_pluginManager;
 PluginManager::LoadedPlugin *	PluginManager::s_currentLoadingPlugin = NULL;
 PluginHandle					PluginManager::s_currentPluginHandle = 0;
 
+// Handle by plugin name, filled as plugins are loaded so lookups from other threads never see it change. The table
+// only keeps the hash of a name, see LookupHandleFromName.
+static UnorderedMap<const char*, PluginHandle> s_pluginHandleByName;
+
 #ifdef RUNTIME
 static NVSEStringVarInterface g_NVSEStringVarInterface =
 {
@@ -48,7 +52,13 @@ static NVSEArrayVarInterface g_NVSEArrayVarInterface =
 	PluginAPI::ArrayAPI::LookupArrayByID,
 	PluginAPI::ArrayAPI::GetElement,
 	PluginAPI::ArrayAPI::GetElements,
-	PluginAPI::ArrayAPI::GetArrayPacked
+	PluginAPI::ArrayAPI::GetArrayPacked,
+	PluginAPI::ArrayAPI::GetContainerType,
+	PluginAPI::ArrayAPI::ArrayHasKey,
+	PluginAPI::ArrayAPI::CreateNumericArray,
+	PluginAPI::ArrayAPI::CreateFormArray,
+	PluginAPI::ArrayAPI::GetNumericArrayValues,
+	PluginAPI::ArrayAPI::GetFormArrayValues
 };
 
 static NVSEScriptInterface g_NVSEScriptInterface =
@@ -110,7 +120,8 @@ static NVSEMessagingInterface g_NVSEMessagingInterface =
 {
 	NVSEMessagingInterface::kVersion,
 	PluginManager::RegisterListener,
-	PluginManager::Dispatch_Message
+	PluginManager::Dispatch_Message,
+	PluginManager::RegisterListenerForMessages
 };
 
 #ifdef RUNTIME
@@ -171,6 +182,7 @@ void PluginManager::DeInit(void)
 	}
 
 	m_plugins.clear();
+	s_pluginHandleByName.Clear();
 }
 
 UInt32 PluginManager::GetNumPlugins(void)
@@ -497,6 +509,11 @@ bool PluginManager::InstallPlugin(std::string pluginPath)
 		{
 			// succeeded, add it to the list
 			m_plugins.push_back(plugin);
+
+			// first match wins, as with the linear search
+			PluginHandle* handle;
+			if (plugin.info.name && s_pluginHandleByName.Insert(plugin.info.name, &handle))
+				*handle = m_plugins.size();
 		}
 		else
 		{
@@ -657,12 +674,56 @@ const char * PluginManager::CheckPluginCompatibility(LoadedPlugin * plugin)
 struct PluginListener {
 	PluginHandle	listener;
 	NVSEMessagingInterface::EventCallback	handleMessage;
+	UInt32			messageMask;	// bit n set = receives message type n, types above 31 are always delivered
+};
+
+// All listeners of one sender, in registration order, plus a table per message type that is rebuilt whenever a
+// listener is added, so dispatching only visits the plugins that asked for that type.
+struct SenderListeners
+{
+	enum { kNumMaskedTypes = 32 };
+
+	std::vector<PluginListener>	all;
+	std::vector<PluginListener>	byType[kNumMaskedTypes];
+
+	const std::vector<PluginListener>& ForType(UInt32 messageType) const
+	{
+		return messageType < kNumMaskedTypes ? byType[messageType] : all;
+	}
+
+	void Add(PluginHandle listener, NVSEMessagingInterface::EventCallback handler, UInt32 messageMask, bool replaceMask)
+	{
+		for (auto& entry : all)
+		{
+			if (entry.listener == listener)
+			{
+				if (!replaceMask || entry.messageMask == messageMask)
+					return;
+				entry.messageMask = messageMask;
+				Rebuild();
+				return;
+			}
+		}
+		all.push_back({listener, handler, messageMask});
+		Rebuild();
+	}
+
+	void Rebuild()
+	{
+		for (UInt32 type = 0; type < kNumMaskedTypes; type++)
+		{
+			byType[type].clear();
+			for (auto& entry : all)
+				if (entry.messageMask & (1U << type))
+					byType[type].push_back(entry);
+		}
+	}
 };
 
-typedef std::vector<std::vector<PluginListener> > PluginListeners;
+typedef std::vector<SenderListeners> PluginListeners;
 static PluginListeners s_pluginListeners;
 
-bool PluginManager::RegisterListener(PluginHandle listener, const char* sender, NVSEMessagingInterface::EventCallback handler)
+static bool AddPluginListener(PluginHandle listener, const char* sender, NVSEMessagingInterface::EventCallback handler, UInt32 messageMask, bool replaceMask)
 {
 	// because this can be called while plugins are loading, gotta make sure number of plugins hasn't increased
 	UInt32 numPlugins = g_pluginManager.GetNumPlugins() + 1;
@@ -687,58 +748,31 @@ bool PluginManager::RegisterListener(PluginHandle listener, const char* sender,
 		{
 			return false;
 		}
-		// is listener already registered?
-		for (std::vector<PluginListener>::iterator iter = s_pluginListeners[target].begin(); iter != s_pluginListeners[target].end(); ++iter)
-		{
-			if (iter->listener == listener)
-			{
-				return true;
-			}
-		}
-
-		// register new listener
-		PluginListener newListener;
-		newListener.handleMessage = handler;
-		newListener.listener = listener;
-
-		s_pluginListeners[target].push_back(newListener);
+		s_pluginListeners[target].Add(listener, handler, messageMask, replaceMask);
 	}
 	else
 	{
-		// register listener to every loaded plugin
-		UInt32 idx = 0;
-		for(PluginListeners::iterator iter = s_pluginListeners.begin(); iter != s_pluginListeners.end(); ++iter)
+		// register listener to every loaded plugin, but don't add the listener to its own list
+		for (UInt32 idx = 1; idx < s_pluginListeners.size(); idx++)
 		{
-			// don't add the listener to its own list
-			if (idx && idx != listener)
-			{
-				bool skipCurrentList = false;
-				for (std::vector<PluginListener>::iterator iterEx = iter->begin(); iterEx != iter->end(); ++iterEx)
-				{
-					// already registered with this plugin, skip it
-					if (iterEx->listener == listener)
-					{
-						skipCurrentList = true;
-						break;
-					}
-				}
-				if (skipCurrentList)
-				{
-					continue;
-				}
-				PluginListener newListener;
-				newListener.handleMessage = handler;
-				newListener.listener = listener;
-
-				iter->push_back(newListener);
-			}
-			idx++;
+			if (idx != listener)
+				s_pluginListeners[idx].Add(listener, handler, messageMask, replaceMask);
 		}
 	}
 
 	return true;
 }
 
+bool PluginManager::RegisterListener(PluginHandle listener, const char* sender, NVSEMessagingInterface::EventCallback handler)
+{
+	return AddPluginListener(listener, sender, handler, 0xFFFFFFFF, false);
+}
+
+bool PluginManager::RegisterListenerForMessages(PluginHandle listener, const char* sender, NVSEMessagingInterface::EventCallback handler, UInt32 messageMask)
+{
+	return AddPluginListener(listener, sender, handler, messageMask, true);
+}
+
 bool PluginManager::Dispatch_Message(PluginHandle sender, UInt32 messageType, void * data, UInt32 dataLen, const char* receiver)
 {
 #ifdef RUNTIME
@@ -746,9 +780,6 @@ bool PluginManager::Dispatch_Message(PluginHandle sender, UInt32 messageType, vo
 	EventManager::HandleNVSEMessage(messageType, data);
 #endif
 	//_DMESSAGE("dispatch message to plugin listeners");
-	UInt32 numRespondents = 0;
-	PluginHandle target = kPluginHandle_Invalid;
-
 	if (!s_pluginListeners.size())	// no listeners yet registered
 	{
 	    _DMESSAGE("no listeners registered");
@@ -760,6 +791,11 @@ bool PluginManager::Dispatch_Message(PluginHandle sender, UInt32 messageType, vo
 		return false;
 	}
 
+	// nobody asked for this message type, e.g. kMessage_MainGameLoop for most plugins
+	if (s_pluginListeners[sender].ForType(messageType).empty())
+		return false;
+
+	PluginHandle target = kPluginHandle_Invalid;
 	if (receiver)
 	{
 		target = g_pluginManager.LookupHandleFromName(receiver);
@@ -771,26 +807,31 @@ bool PluginManager::Dispatch_Message(PluginHandle sender, UInt32 messageType, vo
 	if (!senderName)
 		return false;
 
-	for (std::vector<PluginListener>::iterator iter = s_pluginListeners[sender].begin(); iter != s_pluginListeners[sender].end(); ++iter)
+	NVSEMessagingInterface::Message msgTemplate;
+	msgTemplate.data = data;
+	msgTemplate.type = messageType;
+	msgTemplate.sender = senderName;
+	msgTemplate.dataLen = dataLen;
+
+	// index based and re-fetched every iteration since a handler may register new listeners
+	UInt32 numRespondents = 0;
+	for (UInt32 i = 0; i < s_pluginListeners[sender].ForType(messageType).size(); i++)
 	{
-		NVSEMessagingInterface::Message msg;
-		msg.data = data;
-		msg.type = messageType;
-		msg.sender = senderName;
-		msg.dataLen = dataLen;
+		const PluginListener listener = s_pluginListeners[sender].ForType(messageType)[i];
+		NVSEMessagingInterface::Message msg = msgTemplate;	// each listener gets its own copy
 
 		if (target != kPluginHandle_Invalid)	// sending message to specific plugin
 		{
-			if (iter->listener == target)
+			if (listener.listener == target)
 			{
-				iter->handleMessage(&msg);
+				listener.handleMessage(&msg);
 				return true;
 			}
 		}
 		else
 		{
-		    //_DMESSAGE("sending %u to %u", messageType, iter->listener);
-			iter->handleMessage(&msg);
+		    //_DMESSAGE("sending %u to %u", messageType, listener.listener);
+			listener.handleMessage(&msg);
 			numRespondents++;
 		}
 	}
@@ -800,15 +841,26 @@ bool PluginManager::Dispatch_Message(PluginHandle sender, UInt32 messageType, vo
 
 PluginHandle PluginManager::LookupHandleFromName(const char* pluginName)
 {
+	if (!pluginName)
+		return kPluginHandle_Invalid;
+
 	if (!StrCompare("NVSE", pluginName))
 		return 0;
 
+	// every loaded name is in the table, so a miss is final; a hit only means the hash matched
+	const PluginHandle* handle = s_pluginHandleByName.GetPtr(pluginName);
+	if (!handle)
+		return kPluginHandle_Invalid;
+	if (!StrCompare(m_plugins[*handle - 1].info.name, pluginName))
+		return *handle;
+
+	// another plugin's name has the same hash and took the slot
 	UInt32	idx = 1;
 
 	for (LoadedPluginList::iterator iter = m_plugins.begin(); iter != m_plugins.end(); ++iter)
 	{
 		LoadedPlugin	* plugin = &(*iter);
-		if (!StrCompare(plugin->info.name, pluginName))
+		if (plugin->info.name && !StrCompare(plugin->info.name, pluginName))
 		{
 			return idx;
 		}
@@ -63,5 +63,10 @@ void TokenCache::MarkForClear()
 	++tlsClearAllCookie_;
 }
 
+int TokenCache::GetClearCookie()
+{
+	return tlsClearAllCookie_;
+}
+
 std::atomic<int> TokenCache::tlsClearAllCookie_ = 0;
 thread_local int TokenCache::tlsClearAllToken_ = 0;
\ No newline at end of file
@@ -35,4 +35,5 @@ public:
 	[[nodiscard]] std::size_t Size() const;
 	bool Empty() const;
 	static void MarkForClear();
+	static int GetClearCookie();
 };
\ No newline at end of file
@@ -446,7 +446,7 @@ bool AssignableSubstringStringVarToken::Assign(const char* str)
 			strVar->Erase(lower, upper-lower + 1);
 			if (str) {
 				strVar->Insert(str, lower);
-				substring = strVar->String();
+				substring = strVar->View();
 			}
 			return true;
 		}
@@ -607,12 +607,16 @@ ScriptToken* Eval_TimesEquals_String(OperatorType op, ScriptToken* lh, ScriptTok
 		strVar = g_StringMap.Get(strID);
 	}
 
-	std::string str = strVar->String();
+	// appends the original prefix of the string to itself, no copy needed once the capacity is reserved
+	std::string& str = strVar->StringRef();
+	const auto length = str.length();
 
 	int rhNum = rh->GetNumber();
+	if (rhNum > 0)
+		str.reserve(length * (rhNum + 1));
 	while (rhNum > 0)
 	{
-		strVar->StringRef() += str;
+		str.append(str, 0, length);
 		rhNum--;
 	}
 
@@ -2877,13 +2881,35 @@ bool ExpressionEvaluator::ExtractArgs()
 		return false;
 }
 
+DefaultArgPlan& DefaultArgPlanCache::Get(UInt8* key)
+{
+	const int cookie = TokenCache::GetClearCookie();
+	if (clearToken_ != cookie)
+	{
+		clearToken_ = cookie;
+		cache_.Clear();
+	}
+	return cache_[key];
+}
+
+thread_local DefaultArgPlanCache g_defaultArgPlanCache;
+
 bool ExpressionEvaluator::ExtractDefaultArgs(va_list varArgs, bool bConvertTESForms)
 {
+	// the numArgs byte identifies the call site
+	UInt8* planKey = m_data;
 	if (ExtractArgs()) {
+		// looked up after evaluating, commands run by the args may add plans of their own
+		DefaultArgPlan& plan = g_defaultArgPlanCache.Get(planKey);
+		if (plan.params != m_params || plan.numArgs != NumArgs() || plan.convertTESForms != bConvertTESForms) {
+			plan.params = m_params;
+			plan.numArgs = NumArgs();
+			plan.convertTESForms = bConvertTESForms;
+			for (UInt32 i = 0; i < NumArgs(); i++)
+				plan.converters[i] = GetDefaultArgConverter(m_params[i].typeID, bConvertTESForms);
+		}
 		for (UInt32 i = 0; i < NumArgs(); i++) {
-			ScriptToken* arg = Arg(i);
-			ParamInfo* info = &m_params[i];
-			if (!ConvertDefaultArg(arg, info, bConvertTESForms, varArgs)) {
+			if (!plan.converters[i](Arg(i), varArgs)) {
 				DEBUG_PRINT("Couldn't convert arg %d", i);
 				return false;
 			}
@@ -2981,436 +3007,300 @@ bool ExpressionEvaluator::ExtractFormatStringArgs(va_list varArgs, UInt32 fmtStr
 	return false;
 }
 
-bool ExpressionEvaluator::ConvertDefaultArg(ScriptToken* arg, ParamInfo* info, bool bConvertTESForms, va_list& varArgs)
+// Converters used by ConvertDefaultArg() and the per-call-site plans in ExtractDefaultArgs().
+// Each one handles a single ParamInfo type so the type dispatch happens once, when the converter is selected.
+namespace DefaultArgConverters
 {
-	// hooray humongous switch statements
-	switch (info->typeID) 
+	bool ArrayArg(ScriptToken* arg, va_list& varArgs)
 	{
-		case kParamType_Array: 
-			{
-				UInt32* out = va_arg(varArgs, UInt32*);
-				*out = arg->GetArray();
-			}
+		UInt32* out = va_arg(varArgs, UInt32*);
+		*out = arg->GetArray();
+		return true;
+	}
 
-			break;
-		case kParamType_Integer:
+	bool NumberArg(ScriptToken* arg, va_list& varArgs)
+	{
+		if (!arg->CanConvertTo(kTokenType_Number))
+			return false;
+		UInt32* out = va_arg(varArgs, UInt32*);
+		*out = arg->GetNumber();
+		return true;
+	}
+
+	bool IntegerArg(ScriptToken* arg, va_list& varArgs)
+	{
+		ScriptEventList::Var *var = arg->GetVar();
+		// handle string_var passed as integer to sv_* cmds
+		if (var && arg->CanConvertTo(kTokenType_StringVar))
 		{
-			ScriptEventList::Var *var = arg->GetVar();
-			// handle string_var passed as integer to sv_* cmds
-			if (var && arg->CanConvertTo(kTokenType_StringVar))
-			{
-				UInt32* out = va_arg(varArgs, UInt32*);
-				*out = var->data;
-				break;
-			}
+			UInt32* out = va_arg(varArgs, UInt32*);
+			*out = var->data;
+			return true;
 		}
-		// fall-through intentional
-		case kParamType_QuestStage:
-		case kParamType_CrimeType:
-		case kParamType_AnimationGroup:
-		case kParamType_MiscellaneousStat:
-		case kParamType_FormType:
-		case kParamType_Alignment:
-		case kParamType_EquipType:
-		case kParamType_CriticalStage:
-			if (arg->CanConvertTo(kTokenType_Number)) {
-				UInt32* out = va_arg(varArgs, UInt32*);
-				*out = arg->GetNumber();
-			}
-			else {
-				return false;
-			}
+		return NumberArg(arg, varArgs);
+	}
 
-			break;
-		case kParamType_Float:
-			if (arg->CanConvertTo(kTokenType_Number)) {
-				float* out = va_arg(varArgs, float*);
-				*out = arg->GetNumber();
-			}
-			else {
-				return false;
-			}
-			break;
-		case kParamType_Double:
-			if (arg->CanConvertTo(kTokenType_Number)) {
-				double* out = va_arg(varArgs, double*);
-				*out = arg->GetNumber();
-			}
-			else {
-				return false;
-			}
-			break;
-		case kParamType_String:
-			{
-				const char* str = arg->GetString();
-				if (str) {
-					char* out = va_arg(varArgs, char*);
+	bool FloatArg(ScriptToken* arg, va_list& varArgs)
+	{
+		if (!arg->CanConvertTo(kTokenType_Number))
+			return false;
+		float* out = va_arg(varArgs, float*);
+		*out = arg->GetNumber();
+		return true;
+	}
+
+	bool DoubleArg(ScriptToken* arg, va_list& varArgs)
+	{
+		if (!arg->CanConvertTo(kTokenType_Number))
+			return false;
+		double* out = va_arg(varArgs, double*);
+		*out = arg->GetNumber();
+		return true;
+	}
+
+	bool StringArg(ScriptToken* arg, va_list& varArgs)
+	{
+		const char* str = arg->GetString();
+		if (!str)
+			return false;
+		char* out = va_arg(varArgs, char*);
 #pragma warning(push)
 #pragma warning(disable: 4996)
-					strcpy(out, str);
+		strcpy(out, str);
 #pragma warning(pop)
-				}
-				else {
-					return false;
-				}
-			}
-			break;
-		case kParamType_Axis:
-			{
-				char axis = arg->GetAxis();
-				if (axis != -1) {
-					char* out = va_arg(varArgs, char*);
-					*out = axis;
-				}
-				else {
-					return false;
-				}
-			}
-			break;
-		case kParamType_ActorValue:
-			{
-				UInt32 actorVal = arg->GetActorValue();
-				if (actorVal != eActorVal_NoActorValue) {
-					UInt32* out = va_arg(varArgs, UInt32*);
-					*out = actorVal;
-				}
-				else {
-					return false;
-				}
-			}
-			break;
-		case kParamType_Sex:
-			{
-				UInt32 sex = arg->GetSex();
-				if (sex != -1) {
-					UInt32* out = va_arg(varArgs, UInt32*);
-					*out = sex;
-				}
-				else {
-					return false;
-				}
-			}
-			break;
-		case kParamType_MagicEffect:
-			{
-				return false;
-			}
-			break;
-		default:	// all the rest are TESForm
-			{
-				if (arg->CanConvertTo(kTokenType_Form)) {
-					TESForm* form = arg->GetTESForm();
+		return true;
+	}
 
-					if (!bConvertTESForms) {
-						// we're done
-						TESForm** out = va_arg(varArgs, TESForm**);
-						*out = form;
-					}
-					else if (form) {	// expect form != null
-						// gotta make sure form matches expected type, do pointer cast
-						switch (info->typeID) {
-							case kParamType_ObjectID:
-								if (form->IsInventoryObject()) {
-									TESForm** out = va_arg(varArgs, TESForm**);
-									*out = form;
-								}
-								else {
-									return false;
-								}
-								break;
-							case kParamType_ObjectRef:
-							case kParamType_MapMarker:
-								{
-									TESObjectREFR* refr = DYNAMIC_CAST(form, TESForm, TESObjectREFR);
-									if (refr) {
-										// kParamType_MapMarker must be a mapmarker refr
-										if (info->typeID == kParamType_MapMarker && !refr->IsMapMarker()) {
-											return false;
-										}
-
-										TESObjectREFR** out = va_arg(varArgs, TESObjectREFR**);
-										*out = refr;
-									}
-									else {
-										return false;
-									}
-								}
-								break;
-							case kParamType_Actor:
-								{
-									Actor* actor = DYNAMIC_CAST(form, TESForm, Actor);
-									if (actor) {
-										Actor** out = va_arg(varArgs, Actor**);
-										*out = actor;
-									}
-									else {
-										return false;
-									}
-								}
-								break;
-							case kParamType_SpellItem:
-								{
-									SpellItem* spell = DYNAMIC_CAST(form, TESForm, SpellItem);
-									if (spell || form->typeID == kFormType_Book) {
-										TESForm** out = va_arg(varArgs, TESForm**);
-										*out = form;
-									}
-									else {
-										return false;
-									}
-								}
-								break;
-							case kParamType_Cell:
-								{
-									TESObjectCELL* cell = DYNAMIC_CAST(form, TESForm, TESObjectCELL);
-									if (cell) {
-										TESObjectCELL** out = va_arg(varArgs, TESObjectCELL**);
-										*out = cell;
-									}
-									else {
-										return false;
-									}
-								}
-								break;
-							case kParamType_MagicItem:
-								{
-									MagicItem* magic = DYNAMIC_CAST(form, TESForm, MagicItem);
-									if (magic) {
-										MagicItem** out = va_arg(varArgs, MagicItem**);
-										*out = magic;
-									}
-									else {
-										return false;
-									}
-								}
-								break;
-							case kParamType_TESObject:
-								{
-									TESObject* object = DYNAMIC_CAST(form, TESForm, TESObject);
-									if (object) {
-										TESObject** out = va_arg(varArgs, TESObject**);
-										*out = object;
-									}
-									else {
-										return false;
-									}
-								}
-								break;
-							case kParamType_ActorBase:
-								{
-									TESActorBase* base = DYNAMIC_CAST(form, TESForm, TESActorBase);
-									if (base) {
-										TESActorBase** out = va_arg(varArgs, TESActorBase**);
-										*out = base;
-									}
-									else {
-										return false;
-									}
-								}
-								break;
-							case kParamType_Container:
-								{
-									TESObjectREFR* refr = DYNAMIC_CAST(form, TESForm, TESObjectREFR);
-									if (refr && refr->GetContainer()) {	
-										TESObjectREFR** out = va_arg(varArgs, TESObjectREFR**);
-										*out = refr;
-									}
-									else {
-										return false;
-									}
-								}
-								break;
-							case kParamType_WorldSpace:
-								{
-									TESWorldSpace* space = DYNAMIC_CAST(form, TESForm, TESWorldSpace);
-									if (space) {
-										TESWorldSpace** out = va_arg(varArgs, TESWorldSpace**);
-										*out = space;
-									}
-									else {
-										return false;
-									}
-								}
-								break;
-							case kParamType_AIPackage:
-								{
-									TESPackage* pack = DYNAMIC_CAST(form, TESForm, TESPackage);
-									if (pack) {
-										TESPackage** out = va_arg(varArgs, TESPackage**);
-										*out = pack;
-									}
-									else {
-										return false;
-									}
-								}
-								break;
-							case kParamType_CombatStyle:
-								{
-									TESCombatStyle* style = DYNAMIC_CAST(form, TESForm, TESCombatStyle);
-									if (style) {
-										TESCombatStyle** out = va_arg(varArgs, TESCombatStyle**);
-										*out = style;
-									}
-									else {
-										return false;
-									}
-								}
-								break;
-							case kParamType_LeveledOrBaseChar:
-								{
-									TESNPC* NPC = DYNAMIC_CAST(form, TESForm, TESNPC);
-									if (NPC) {
-										TESForm** out = va_arg(varArgs, TESForm**);
-										*out = form;
-									}
-									else {
-										TESLevCharacter* lev = DYNAMIC_CAST(form, TESForm, TESLevCharacter);
-										if (lev) {
-											TESForm** out = va_arg(varArgs, TESForm**);
-											*out = form;
-										}
-										else {
-											return false;
-										}
-									}
-								}
-								break;
-							case kParamType_LeveledOrBaseCreature:
-								{
-									TESCreature* crea = DYNAMIC_CAST(form, TESForm, TESCreature);
-									if (crea) {
-										TESForm** out = va_arg(varArgs, TESForm**);
-										*out = form;
-									}
-									else {
-										TESLevCreature* lev = DYNAMIC_CAST(form, TESForm, TESLevCreature);
-										if (lev) {
-											TESForm** out = va_arg(varArgs, TESForm**);
-											*out = form;
-										}
-										else {
-											return false;
-										}
-									}
-								}
-								break;
-							case kParamType_Owner:
-							case kParamType_AnyForm:
-								{
-									TESForm** out = va_arg(varArgs, TESForm**);
-									*out = form;
-								}
-								break;
-							case kParamType_InvObjOrFormList:
-								{
-									if (form->IsInventoryObject() || (form->typeID == kFormType_ListForm)) {
-										TESForm** out = va_arg(varArgs, TESForm**);
-										*out = form;
-									}
-									else {
-										return false;
-									}
-								}
-								break;
-							case kParamType_NonFormList:
-								{
-									if (form->Unk_3A() && (form->typeID != kFormType_ListForm)) {
-										TESForm** out = va_arg(varArgs, TESForm**);
-										*out = form;
-									}
-									else {
-										return false;
-									}
-								}
-								break;
-							default:
-								// these all check against a particular formtype, return TESForm*
-								{
-									UInt32 typeToMatch = -1;
-									switch (info->typeID) {
-										case kParamType_Sound:
-											typeToMatch = kFormType_Sound; break;
-										case kParamType_Topic:
-											typeToMatch = kFormType_DIAL; break;
-										case kParamType_Quest:
-											typeToMatch = kFormType_Quest; break;
-										case kParamType_Race:
-											typeToMatch = kFormType_Race; break;
-										case kParamType_Faction:
-											typeToMatch = kFormType_Faction; break;
-										case kParamType_Class:
-											typeToMatch = kFormType_Class; break;
-										case kParamType_Global:
-											typeToMatch = kFormType_Global; break;
-										case kParamType_Furniture:
-											typeToMatch = kFormType_Furniture; break;
-										case kParamType_FormList:
-											typeToMatch = kFormType_ListForm; break;
-										case kParamType_WeatherID:
-											typeToMatch = kFormType_Weather; break;
-										case kParamType_NPC:
-											typeToMatch = kFormType_NPC; break;
-										case kParamType_EffectShader:
-											typeToMatch = kFormType_EffectShader; break;
-										case kParamType_MenuIcon:
-											typeToMatch = kFormType_MenuIcon; break;
-										case kParamType_Perk:
-											typeToMatch = kFormType_Perk; break;
-										case kParamType_Note:
-											typeToMatch = kFormType_Note; break;
-										case kParamType_ImageSpaceModifier:
-											typeToMatch = kFormType_ImageSpaceModifier; break;
-										case kParamType_ImageSpace:
-											typeToMatch = kFormType_ImageSpace; break;
-										case kParamType_EncounterZone:
-											typeToMatch = kFormType_EncounterZone; break;
-										case kParamType_Message:
-											typeToMatch = kFormType_Message; break;
-										case kParamType_SoundFile:
-											typeToMatch = kFormType_SoundFile; break;
-										case kParamType_LeveledChar:
-											typeToMatch = kFormType_LeveledCharacter; break;
-										case kParamType_LeveledCreature:
-											typeToMatch = kFormType_LeveledCreature; break;
-										case kParamType_LeveledItem:
-											typeToMatch = kFormType_LeveledItem; break;
-										case kParamType_Reputation:
-											typeToMatch = kFormType_Reputation; break;
-										case kParamType_Casino:
-											typeToMatch = kFormType_Casino; break;
-										case kParamType_CasinoChip:
-											typeToMatch = kFormType_CasinoChip; break;
-										case kParamType_Challenge:
-											typeToMatch = kFormType_Challenge; break;
-										case kParamType_CaravanMoney:
-											typeToMatch = kFormType_CaravanMoney; break;
-										case kParamType_CaravanCard:
-											typeToMatch = kFormType_CaravanCard; break;
-										case kParamType_CaravanDeck:
-											typeToMatch = kFormType_CaravanDeck; break;
-										case kParamType_Region:
-											typeToMatch = kFormType_Region; break;
-									}
-
-									if (form->typeID == typeToMatch) {
-										TESForm** out = va_arg(varArgs, TESForm**);
-										*out = form;
-									}
-									else {
-										return false;
-									}
-								}
-						}
-					}
-					else {
-						// null form
-						return false;
-					}
-				}
-			}
+	bool AxisArg(ScriptToken* arg, va_list& varArgs)
+	{
+		char axis = arg->GetAxis();
+		if (axis == -1)
+			return false;
+		char* out = va_arg(varArgs, char*);
+		*out = axis;
+		return true;
 	}
 
-	return true;
+	bool ActorValueArg(ScriptToken* arg, va_list& varArgs)
+	{
+		UInt32 actorVal = arg->GetActorValue();
+		if (actorVal == eActorVal_NoActorValue)
+			return false;
+		UInt32* out = va_arg(varArgs, UInt32*);
+		*out = actorVal;
+		return true;
+	}
+
+	bool SexArg(ScriptToken* arg, va_list& varArgs)
+	{
+		UInt32 sex = arg->GetSex();
+		if (sex == -1)
+			return false;
+		UInt32* out = va_arg(varArgs, UInt32*);
+		*out = sex;
+		return true;
+	}
+
+	bool UnsupportedArg(ScriptToken* arg, va_list& varArgs)
+	{
+		return false;
+	}
+
+	// ExtractArgsEx() passes forms through unchecked, null included
+	bool RawFormArg(ScriptToken* arg, va_list& varArgs)
+	{
+		TESForm** out = va_arg(varArgs, TESForm**);
+		*out = arg->GetTESForm();
+		return true;
+	}
+
+	// ExtractArgs() expects a non-null form matching the param type
+	TESForm* GetForm(ScriptToken* arg)
+	{
+		return arg->CanConvertTo(kTokenType_Form) ? arg->GetTESForm() : nullptr;
+	}
+
+	template <typename T>
+	bool Store(T* value, va_list& varArgs)
+	{
+		if (!value)
+			return false;
+		T** out = va_arg(varArgs, T**);
+		*out = value;
+		return true;
+	}
+
+	bool AnyFormArg(ScriptToken* arg, va_list& varArgs)
+	{
+		return Store(GetForm(arg), varArgs);
+	}
+
+	bool ObjectIDArg(ScriptToken* arg, va_list& varArgs)
+	{
+		TESForm* form = GetForm(arg);
+		return form && form->IsInventoryObject() && Store(form, varArgs);
+	}
+
+	bool ObjectRefArg(ScriptToken* arg, va_list& varArgs)
+	{
+		return Store(DYNAMIC_CAST(GetForm(arg), TESForm, TESObjectREFR), varArgs);
+	}
+
+	bool MapMarkerArg(ScriptToken* arg, va_list& varArgs)
+	{
+		TESObjectREFR* refr = DYNAMIC_CAST(GetForm(arg), TESForm, TESObjectREFR);
+		return refr && refr->IsMapMarker() && Store(refr, varArgs);
+	}
+
+	bool ContainerArg(ScriptToken* arg, va_list& varArgs)
+	{
+		TESObjectREFR* refr = DYNAMIC_CAST(GetForm(arg), TESForm, TESObjectREFR);
+		return refr && refr->GetContainer() && Store(refr, varArgs);
+	}
+
+	bool SpellItemArg(ScriptToken* arg, va_list& varArgs)
+	{
+		TESForm* form = GetForm(arg);
+		return form && (DYNAMIC_CAST(form, TESForm, SpellItem) || form->typeID == kFormType_Book) && Store(form, varArgs);
+	}
+
+	bool ActorArg(ScriptToken* arg, va_list& varArgs) { return Store(DYNAMIC_CAST(GetForm(arg), TESForm, Actor), varArgs); }
+	bool CellArg(ScriptToken* arg, va_list& varArgs) { return Store(DYNAMIC_CAST(GetForm(arg), TESForm, TESObjectCELL), varArgs); }
+	bool MagicItemArg(ScriptToken* arg, va_list& varArgs) { return Store(DYNAMIC_CAST(GetForm(arg), TESForm, MagicItem), varArgs); }
+	bool TESObjectArg(ScriptToken* arg, va_list& varArgs) { return Store(DYNAMIC_CAST(GetForm(arg), TESForm, TESObject), varArgs); }
+	bool ActorBaseArg(ScriptToken* arg, va_list& varArgs) { return Store(DYNAMIC_CAST(GetForm(arg), TESForm, TESActorBase), varArgs); }
+	bool WorldSpaceArg(ScriptToken* arg, va_list& varArgs) { return Store(DYNAMIC_CAST(GetForm(arg), TESForm, TESWorldSpace), varArgs); }
+	bool AIPackageArg(ScriptToken* arg, va_list& varArgs) { return Store(DYNAMIC_CAST(GetForm(arg), TESForm, TESPackage), varArgs); }
+	bool CombatStyleArg(ScriptToken* arg, va_list& varArgs) { return Store(DYNAMIC_CAST(GetForm(arg), TESForm, TESCombatStyle), varArgs); }
+
+	bool LeveledOrBaseCharArg(ScriptToken* arg, va_list& varArgs)
+	{
+		TESForm* form = GetForm(arg);
+		return form && (DYNAMIC_CAST(form, TESForm, TESNPC) || DYNAMIC_CAST(form, TESForm, TESLevCharacter)) && Store(form, varArgs);
+	}
+
+	bool LeveledOrBaseCreatureArg(ScriptToken* arg, va_list& varArgs)
+	{
+		TESForm* form = GetForm(arg);
+		return form && (DYNAMIC_CAST(form, TESForm, TESCreature) || DYNAMIC_CAST(form, TESForm, TESLevCreature)) && Store(form, varArgs);
+	}
+
+	bool InvObjOrFormListArg(ScriptToken* arg, va_list& varArgs)
+	{
+		TESForm* form = GetForm(arg);
+		return form && (form->IsInventoryObject() || form->typeID == kFormType_ListForm) && Store(form, varArgs);
+	}
+
+	bool NonFormListArg(ScriptToken* arg, va_list& varArgs)
+	{
+		TESForm* form = GetForm(arg);
+		return form && form->Unk_3A() && form->typeID != kFormType_ListForm && Store(form, varArgs);
+	}
+
+	template <UInt32 formType>
+	bool FormOfTypeArg(ScriptToken* arg, va_list& varArgs)
+	{
+		TESForm* form = GetForm(arg);
+		return form && form->typeID == formType && Store(form, varArgs);
+	}
+
+	// an arg that can't convert to a form is skipped without consuming its out pointer and doesn't fail the
+	// extraction, as before the converters were split up; only a null form or one of the wrong type does
+	template <DefaultArgConverter convert>
+	bool FormArg(ScriptToken* arg, va_list& varArgs)
+	{
+		return !arg->CanConvertTo(kTokenType_Form) || convert(arg, varArgs);
+	}
+}
+
+DefaultArgConverter GetDefaultArgConverter(UInt32 paramType, bool bConvertTESForms)
+{
+	using namespace DefaultArgConverters;
+	switch (paramType)
+	{
+	case kParamType_Array:				return ArrayArg;
+	case kParamType_Integer:			return IntegerArg;
+	case kParamType_QuestStage:
+	case kParamType_CrimeType:
+	case kParamType_AnimationGroup:
+	case kParamType_MiscellaneousStat:
+	case kParamType_FormType:
+	case kParamType_Alignment:
+	case kParamType_EquipType:
+	case kParamType_CriticalStage:		return NumberArg;
+	case kParamType_Float:				return FloatArg;
+	case kParamType_Double:				return DoubleArg;
+	case kParamType_String:				return StringArg;
+	case kParamType_Axis:				return AxisArg;
+	case kParamType_ActorValue:			return ActorValueArg;
+	case kParamType_Sex:				return SexArg;
+	case kParamType_MagicEffect:		return UnsupportedArg;
+	}
+
+	// all the rest are TESForm
+	if (!bConvertTESForms)
+		return FormArg<RawFormArg>;
+
+	switch (paramType)
+	{
+	case kParamType_ObjectID:			return FormArg<ObjectIDArg>;
+	case kParamType_ObjectRef:			return FormArg<ObjectRefArg>;
+	case kParamType_MapMarker:			return FormArg<MapMarkerArg>;
+	case kParamType_Actor:				return FormArg<ActorArg>;
+	case kParamType_SpellItem:			return FormArg<SpellItemArg>;
+	case kParamType_Cell:				return FormArg<CellArg>;
+	case kParamType_MagicItem:			return FormArg<MagicItemArg>;
+	case kParamType_TESObject:			return FormArg<TESObjectArg>;
+	case kParamType_ActorBase:			return FormArg<ActorBaseArg>;
+	case kParamType_Container:			return FormArg<ContainerArg>;
+	case kParamType_WorldSpace:			return FormArg<WorldSpaceArg>;
+	case kParamType_AIPackage:			return FormArg<AIPackageArg>;
+	case kParamType_CombatStyle:		return FormArg<CombatStyleArg>;
+	case kParamType_LeveledOrBaseChar:		return FormArg<LeveledOrBaseCharArg>;
+	case kParamType_LeveledOrBaseCreature:	return FormArg<LeveledOrBaseCreatureArg>;
+	case kParamType_Owner:
+	case kParamType_AnyForm:			return FormArg<AnyFormArg>;
+	case kParamType_InvObjOrFormList:	return FormArg<InvObjOrFormListArg>;
+	case kParamType_NonFormList:		return FormArg<NonFormListArg>;
+	// these all check against a particular formtype, return TESForm*
+	case kParamType_Sound:				return FormArg<FormOfTypeArg<kFormType_Sound>>;
+	case kParamType_Topic:				return FormArg<FormOfTypeArg<kFormType_DIAL>>;
+	case kParamType_Quest:				return FormArg<FormOfTypeArg<kFormType_Quest>>;
+	case kParamType_Race:				return FormArg<FormOfTypeArg<kFormType_Race>>;
+	case kParamType_Faction:			return FormArg<FormOfTypeArg<kFormType_Faction>>;
+	case kParamType_Class:				return FormArg<FormOfTypeArg<kFormType_Class>>;
+	case kParamType_Global:				return FormArg<FormOfTypeArg<kFormType_Global>>;
+	case kParamType_Furniture:			return FormArg<FormOfTypeArg<kFormType_Furniture>>;
+	case kParamType_FormList:			return FormArg<FormOfTypeArg<kFormType_ListForm>>;
+	case kParamType_WeatherID:			return FormArg<FormOfTypeArg<kFormType_Weather>>;
+	case kParamType_NPC:				return FormArg<FormOfTypeArg<kFormType_NPC>>;
+	case kParamType_EffectShader:		return FormArg<FormOfTypeArg<kFormType_EffectShader>>;
+	case kParamType_MenuIcon:			return FormArg<FormOfTypeArg<kFormType_MenuIcon>>;
+	case kParamType_Perk:				return FormArg<FormOfTypeArg<kFormType_Perk>>;
+	case kParamType_Note:				return FormArg<FormOfTypeArg<kFormType_Note>>;
+	case kParamType_ImageSpaceModifier:	return FormArg<FormOfTypeArg<kFormType_ImageSpaceModifier>>;
+	case kParamType_ImageSpace:			return FormArg<FormOfTypeArg<kFormType_ImageSpace>>;
+	case kParamType_EncounterZone:		return FormArg<FormOfTypeArg<kFormType_EncounterZone>>;
+	case kParamType_Message:			return FormArg<FormOfTypeArg<kFormType_Message>>;
+	case kParamType_SoundFile:			return FormArg<FormOfTypeArg<kFormType_SoundFile>>;
+	case kParamType_LeveledChar:		return FormArg<FormOfTypeArg<kFormType_LeveledCharacter>>;
+	case kParamType_LeveledCreature:	return FormArg<FormOfTypeArg<kFormType_LeveledCreature>>;
+	case kParamType_LeveledItem:		return FormArg<FormOfTypeArg<kFormType_LeveledItem>>;
+	case kParamType_Reputation:			return FormArg<FormOfTypeArg<kFormType_Reputation>>;
+	case kParamType_Casino:				return FormArg<FormOfTypeArg<kFormType_Casino>>;
+	case kParamType_CasinoChip:			return FormArg<FormOfTypeArg<kFormType_CasinoChip>>;
+	case kParamType_Challenge:			return FormArg<FormOfTypeArg<kFormType_Challenge>>;
+	case kParamType_CaravanMoney:		return FormArg<FormOfTypeArg<kFormType_CaravanMoney>>;
+	case kParamType_CaravanCard:		return FormArg<FormOfTypeArg<kFormType_CaravanCard>>;
+	case kParamType_CaravanDeck:		return FormArg<FormOfTypeArg<kFormType_CaravanDeck>>;
+	case kParamType_Region:				return FormArg<FormOfTypeArg<kFormType_Region>>;
+	default:							return FormArg<UnsupportedArg>;
+	}
+}
+
+bool ExpressionEvaluator::ConvertDefaultArg(ScriptToken* arg, ParamInfo* info, bool bConvertTESForms, va_list& varArgs)
+{
+	return GetDefaultArgConverter(info->typeID, bConvertTESForms)(arg, varArgs);
 }
 
 ScriptToken* ExpressionEvaluator::ExecuteCommandToken(ScriptToken const* token)
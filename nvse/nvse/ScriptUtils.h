@@ -59,6 +59,28 @@ enum {
 
 #define NVSE_EXPR_MAX_ARGS 20		// max # of args we'll accept to a commmand
 
+// converts an evaluated arg to the type expected by ExtractArgs/Ex() and stores it in the next vararg
+typedef bool (*DefaultArgConverter)(ScriptToken* arg, va_list& varArgs);
+DefaultArgConverter GetDefaultArgConverter(UInt32 paramType, bool bConvertTESForms);
+
+// converters chosen for one call site of a command compiled with the compiler override
+struct DefaultArgPlan
+{
+	ParamInfo			* params = nullptr;
+	UInt8				numArgs = 0;
+	bool				convertTESForms = false;
+	DefaultArgConverter	converters[NVSE_EXPR_MAX_ARGS];
+};
+
+// keyed by script data position like TokenCache, and cleared along with it
+class DefaultArgPlanCache
+{
+	UnorderedMap<UInt8*, DefaultArgPlan> cache_;
+	int clearToken_ = 0;
+public:
+	DefaultArgPlan& Get(UInt8* key);
+};
+
 // wraps a dynamic ParamInfo array
 struct DynamicParamInfo
 {
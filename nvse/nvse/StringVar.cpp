@@ -30,6 +30,11 @@ void StringVar::Set(const char* newString)
 	data = newString;
 }
 
+void StringVar::Set(std::string_view newString)
+{
+	data.assign(newString.data(), newString.size());
+}
+
 SInt32 StringVar::Compare(char* rhs, bool caseSensitive)
 {
 	return caseSensitive ? strcmp(rhs, data.c_str()) : StrCompare(rhs, data.c_str());
@@ -43,27 +48,28 @@ void StringVar::Insert(const char* subString, UInt32 insertionPos)
 		data.append(subString);
 }
 
-#pragma warning(disable : 4996)	// disable checked iterator warning for std::transform with char*
+// searches data[startPos, endPos) in place instead of on a (lowercased) copy, returns -1 if not found
+static UInt32 FindInRange(const std::string& data, const char* subString, UInt32 subStringLen, UInt32 startPos, UInt32 endPos, bool bCaseSensitive)
+{
+	if (endPos < startPos || endPos > data.size())
+		return -1;
+	if (!subStringLen)
+		return startPos;
+	const auto begin = data.begin() + startPos, end = data.begin() + endPos;
+	const auto iter = bCaseSensitive ? std::search(begin, end, subString, subString + subStringLen)
+		: std::search(begin, end, subString, subString + subStringLen, ci_equal);
+	return iter != end ? iter - data.begin() : -1;
+}
+
 UInt32 StringVar::Find(char* subString, UInt32 startPos, UInt32 numChars, bool bCaseSensitive)
 {
 	UInt32 pos = -1;
 
-	if (numChars + startPos >= GetLength())
-		numChars = GetLength() - startPos;
-
 	if (startPos < GetLength())
 	{
-		std::string source = data.substr(startPos, numChars);
-		if (!bCaseSensitive)
-		{
-			std::transform(source.begin(), source.end(), source.begin(), tolower);
-			std::transform(subString, subString + strlen(subString), subString, tolower);
-		}
-
-		 //pos = data.substr(startPos, numChars).find(subString);	//returns -1 if not found
-		pos = source.find(subString);
-		if (pos != -1)
-			pos += startPos;
+		// clamped without adding to startPos, which can wrap around for a large numChars
+		numChars = min(numChars, GetLength() - startPos);
+		pos = FindInRange(data, subString, strlen(subString), startPos, startPos + numChars, bCaseSensitive);
 	}
 
 	return pos;
@@ -71,26 +77,19 @@ UInt32 StringVar::Find(char* subString, UInt32 startPos, UInt32 numChars, bool b
 
 UInt32 StringVar::Count(char* subString, UInt32 startPos, UInt32 numChars, bool bCaseSensitive)
 {
-	if (numChars + startPos >= GetLength())
-		numChars = GetLength() - startPos;
-
 	if (startPos >= GetLength())
 		return 0;
+	numChars = min(numChars, GetLength() - startPos);
 
-	std::string source = data.substr(startPos, numChars);	//only count occurences beginning before endPos
 	UInt32 subStringLen = strlen(subString);
 	if (!subStringLen)
 		return 0;
 
-	if (!bCaseSensitive)
-	{
-		std::transform(source.begin(), source.end(), source.begin(), tolower);
-		std::transform(subString, subString + strlen(subString), subString, tolower);
-	}
-
-	UInt32 strIdx = 0;
+	//only count occurences beginning before endPos
+	const UInt32 endPos = startPos + numChars;
+	UInt32 strIdx = startPos;
 	UInt32 count = 0;
-	while (strIdx < GetLength() && ((strIdx = source.find(subString, strIdx)) != -1))
+	while ((strIdx = FindInRange(data, subString, subStringLen, strIdx, endPos, bCaseSensitive)) != -1)
 	{
 		count++;
 		strIdx += subStringLen;
@@ -98,7 +97,6 @@ UInt32 StringVar::Count(char* subString, UInt32 startPos, UInt32 numChars, bool
 
 	return count;
 }
-#pragma warning(default : 4996)
 
 UInt32 StringVar::GetLength()
 {
@@ -110,57 +108,40 @@ UInt32 StringVar::Replace(char* toReplace, char* replaceWith, UInt32 startPos, U
 	// calc length of substring
 	if (startPos >= GetLength())
 		return 0;
-	else if (numChars + startPos > GetLength())
-		numChars = GetLength() - startPos;
+	numChars = min(numChars, GetLength() - startPos);
 
 	UInt32 numReplaced = 0;
 	UInt32 replacementLen = strlen(replaceWith);
 	UInt32 toReplaceLen = strlen(toReplace);
-
-	// create substring
-	std::string srcStr = data.substr(startPos, numChars);
-
-	// remove substring from original string
-	data.erase(startPos, numChars);
-
-	UInt32 strIdx = 0;
-	while (numReplaced < numToReplace)// && (strIdx = srcStr.find(toReplace, strIdx)) != -1)
+	if (!toReplaceLen && (numToReplace == -1))
+		return 0;		// would insert replaceWith forever
+
+	// build the result in a single pass instead of erasing/inserting into the string for each match
+	const UInt32 endPos = startPos + numChars;
+	std::string result;
+	UInt32 strIdx = startPos;
+	while (numReplaced < numToReplace)
 	{
-		if (bCaseSensitive)
-		{
-			strIdx = srcStr.find(toReplace, strIdx);
-			if (strIdx == -1)
-				break;
-		}
-		else
+		const UInt32 matchPos = FindInRange(data, toReplace, toReplaceLen, strIdx, endPos, bCaseSensitive);
+		if (matchPos == -1)
+			break;
+		if (!numReplaced)
 		{
-			std::string strToReplace = toReplace;
-			std::string::iterator iter = std::search(srcStr.begin() + strIdx, srcStr.end(), strToReplace.begin(), strToReplace.end(), ci_equal);
-			if (iter != srcStr.end())
-				strIdx = iter - srcStr.begin();
-			else
-				break;
+			result.reserve(data.length());
+			result.append(data, 0, startPos);
 		}
 
 		numReplaced++;
-		srcStr.erase(strIdx, toReplaceLen);
-		if (strIdx == srcStr.length())
-		{
-			srcStr.append(replaceWith);
-			break;						// reached end of string so all done
-		}
-		else
-		{
-			srcStr.insert(strIdx, replaceWith);
-			strIdx += replacementLen;
-		}
+		result.append(data, strIdx, matchPos - strIdx);
+		result.append(replaceWith, replacementLen);
+		strIdx = matchPos + toReplaceLen;
 	}
 
-	// paste altered string back into original string
-	if (startPos == GetLength())
-		data.append(srcStr);
-	else
-		data.insert(startPos, srcStr);
+	if (numReplaced)
+	{
+		result.append(data, strIdx, std::string::npos);
+		data.swap(result);
+	}
 
 	return numReplaced;
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include <string_view>
 #include "Serialization.h"
 #include "GameAPI.h"
 #include "VarMap.h"
@@ -25,6 +26,7 @@ public:
 	StringVar(const char* in_data, UInt8 modIndex);
 
 	void		Set(const char* newString);
+	void		Set(std::string_view newString);
 	SInt32		Compare(char* rhs, bool caseSensitive);
 	void		Insert(const char* subString, UInt32 insertionPos);
 	UInt32		Find(char* subString, UInt32 startPos, UInt32 numChars, bool bCaseSensitive = false);	//returns position of substring
@@ -35,7 +37,8 @@ public:
 	char		At(UInt32 charPos);
 	static UInt32	GetCharType(char ch);
 
-	std::string String()					{	return data;	}
+	const std::string& String() const		{	return data;	}
+	std::string_view View() const			{	return data;	}
 	std::string& StringRef() {return data;}
 	const char*	GetCString();
 	UInt32		GetLength();
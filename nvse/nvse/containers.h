@@ -813,6 +813,12 @@ public:
 			index--;
 		}
 
+		void operator+=(UInt32 count)
+		{
+			pEntry += count;
+			index += count;
+		}
+
 		void Find(Map &source, Key_Arg key)
 		{
 			table = &source;
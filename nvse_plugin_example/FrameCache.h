@@ -0,0 +1,114 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+
+// Open addressed cache for results that are only valid until the next Clear(), e.g. for the rest of the frame.
+// Every slot carries the generation it was written in, so Clear() is a single increment instead of a walk over
+// the buckets, and slots are reused instead of allocating a node per insert. The table only grows (doubling once
+// half full) while warming up, entries are never evicted since callers rely on getting the same result back.
+// Not thread safe, meant to be used as a thread_local.
+template <typename Key, typename Value, typename Hash, typename Equal = std::equal_to<Key>, UInt32 kInitialCapacity = 256>
+class FrameCache
+{
+	static_assert((kInitialCapacity & (kInitialCapacity - 1)) == 0, "capacity must be a power of two");
+
+	struct Slot
+	{
+		UInt32 generation = 0;
+		Key key{};
+		Value value{};
+	};
+
+	std::unique_ptr<Slot[]> slots;
+	UInt32 capacity = 0;
+	UInt32 numEntries = 0;
+	UInt32 generation = 1;
+
+	UInt32 StartIndex(const Key& key) const
+	{
+		return (static_cast<UInt32>(Hash()(key)) * 0x9E3779B1) & (capacity - 1);
+	}
+
+	Slot* FindSlot(const Key& key) const
+	{
+		if (!numEntries)
+			return nullptr;
+		for (UInt32 index = StartIndex(key);; index = (index + 1) & (capacity - 1))
+		{
+			Slot& slot = slots[index];
+			if (slot.generation != generation)
+				return nullptr;
+			if (Equal()(slot.key, key))
+				return &slot;
+		}
+	}
+
+	Slot& InsertSlot(const Key& key)
+	{
+		UInt32 index = StartIndex(key);
+		while (slots[index].generation == generation)
+			index = (index + 1) & (capacity - 1);
+		++numEntries;
+		Slot& slot = slots[index];
+		slot.generation = generation;
+		slot.key = key;
+		return slot;
+	}
+
+	void Grow()
+	{
+		// fresh slots have generation 0, so the current generation stays valid
+		auto oldSlots = std::move(slots);
+		const auto oldCapacity = capacity;
+		capacity = oldCapacity ? oldCapacity * 2 : kInitialCapacity;
+		slots = std::make_unique<Slot[]>(capacity);
+		numEntries = 0;
+		for (UInt32 i = 0; i < oldCapacity; ++i)
+		{
+			if (oldSlots[i].generation == generation)
+				InsertSlot(oldSlots[i].key).value = std::move(oldSlots[i].value);
+		}
+	}
+
+public:
+	// Returns the cached value and false, or inserts a default constructed placeholder and returns it with true.
+	// The pointer is only valid until the next Emplace, store the computed result with Set.
+	std::pair<Value*, bool> Emplace(const Key& key)
+	{
+		if (Slot* slot = FindSlot(key))
+			return {&slot->value, false};
+		if ((numEntries + 1) * 2 > capacity)
+			Grow();
+		Slot& slot = InsertSlot(key);
+		slot.value = Value();
+		return {&slot.value, true};
+	}
+
+	Value* Find(const Key& key)
+	{
+		Slot* slot = FindSlot(key);
+		return slot ? &slot->value : nullptr;
+	}
+
+	// does nothing if the cache has been cleared since the key was emplaced
+	void Set(const Key& key, const Value& value)
+	{
+		if (Slot* slot = FindSlot(key))
+			slot->value = value;
+	}
+
+	void Clear()
+	{
+		numEntries = 0;
+		if (++generation == 0)
+		{
+			// wrapped around, stale slots could look current again
+			for (UInt32 i = 0; i < capacity; ++i)
+				slots[i].generation = 0;
+			generation = 1;
+		}
+	}
+
+	UInt32 Size() const { return numEntries; }
+};
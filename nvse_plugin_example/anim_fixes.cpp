@@ -364,10 +364,10 @@ void AnimFixes::FixWrongKFName(BSAnimGroupSequence* anim, const char* filePath)
 	if (sv::equals_ci(baseAnimGroupName, kfGroupName)
 		|| !sv::contains_ci(filePath, "animgroupoverride")) [[likely]]
 		return;
-	auto iter = ra::find_if(g_animGroupInfos, _L(AnimGroupInfo& i, sv::equals_ci(i.name, baseAnimGroupName)));
-	if (iter == g_animGroupInfos.end())
+	const auto groupId = GroupNameToId(baseAnimGroupName);
+	if (groupId == kAnimGroup_Invalid)
 		return;
 	LogAnimError(filePath, FormatString("Fixed wrong KF name %s", anim->m_kName.CStr()));
-	anim->m_kName = iter->name;
+	anim->m_kName = g_animGroupInfos[groupId].name;
 }
 
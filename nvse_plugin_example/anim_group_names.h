@@ -0,0 +1,208 @@
+﻿#pragma once
+#include <array>
+#include <string_view>
+
+// Compile time tables for the vanilla anim group, move type and hand type names so that anim file names can be
+// resolved without scanning the engine's AnimGroupInfo table (0x11977D8) or calling GetMoveHandAndPowerArmorTypeFromAnimName.
+// Group names are in AnimGroupID order, prefixes mirror the engine tables at 0x1197798 and 0x11977A8.
+namespace AnimGroupNames
+{
+	constexpr UInt8 kInvalidGroupId = 0xFF;
+
+	constexpr std::array<std::string_view, 245> kGroupNames =
+	{
+		"Idle", "DynamicIdle", "SpecialIdle", "Forward", "Backward", "Left",
+		"Right", "FastForward", "FastBackward", "FastLeft", "FastRight", "DodgeForward",
+		"DodgeBack", "DodgeLeft", "DodgeRight", "TurnLeft", "TurnRight", "Aim",
+		"AimUp", "AimDown", "AimIS", "AimISUp", "AimISDown", "Holster",
+		"Equip", "Unequip", "AttackLeft", "AttackLeftUp", "AttackLeftDown", "AttackLeftIS",
+		"AttackLeftISUp", "AttackLeftISDown", "AttackRight", "AttackRightUp", "AttackRightDown", "AttackRightIS",
+		"AttackRightISUp", "AttackRightISDown", "Attack3", "Attack3Up", "Attack3Down", "Attack3IS",
+		"Attack3ISUp", "Attack3ISDown", "Attack4", "Attack4Up", "Attack4Down", "Attack4IS",
+		"Attack4ISUp", "Attack4ISDown", "Attack5", "Attack5Up", "Attack5Down", "Attack5IS",
+		"Attack5ISUp", "Attack5ISDown", "Attack6", "Attack6Up", "Attack6Down", "Attack6IS",
+		"Attack6ISUp", "Attack6ISDown", "Attack7", "Attack7Up", "Attack7Down", "Attack7IS",
+		"Attack7ISUp", "Attack7ISDown", "Attack8", "Attack8Up", "Attack8Down", "Attack8IS",
+		"Attack8ISUp", "Attack8ISDown", "AttackLoop", "AttackLoopUp", "AttackLoopDown", "AttackLoopIS",
+		"AttackLoopISUp", "AttackLoopISDown", "AttackSpin", "AttackSpinUp", "AttackSpinDown", "AttackSpinIS",
+		"AttackSpinISUp", "AttackSpinISDown", "AttackSpin2", "AttackSpin2Up", "AttackSpin2Down", "AttackSpin2IS",
+		"AttackSpin2ISUp", "AttackSpin2ISDown", "AttackPower", "AttackForwardPower", "AttackBackPower", "AttackLeftPower",
+		"AttackRightPower", "AttackCustom1Power", "AttackCustom2Power", "AttackCustom3Power", "AttackCustom4Power", "AttackCustom5Power",
+		"PlaceMine", "PlaceMineUp", "PlaceMineDown", "PlaceMineIS", "PlaceMineISUp", "PlaceMineISDown",
+		"PlaceMine2", "PlaceMine2Up", "PlaceMine2Down", "PlaceMine2IS", "PlaceMine2ISUp", "PlaceMine2ISDown",
+		"AttackThrow", "AttackThrowUp", "AttackThrowDown", "AttackThrowIS", "AttackThrowISUp", "AttackThrowISDown",
+		"AttackThrow2", "AttackThrow2Up", "AttackThrow2Down", "AttackThrow2IS", "AttackThrow2ISUp", "AttackThrow2ISDown",
+		"AttackThrow3", "AttackThrow3Up", "AttackThrow3Down", "AttackThrow3IS", "AttackThrow3ISUp", "AttackThrow3ISDown",
+		"AttackThrow4", "AttackThrow4Up", "AttackThrow4Down", "AttackThrow4IS", "AttackThrow4ISUp", "AttackThrow4ISDown",
+		"AttackThrow5", "AttackThrow5Up", "AttackThrow5Down", "AttackThrow5IS", "AttackThrow5ISUp", "AttackThrow5ISDown",
+		"Attack9", "Attack9Up", "Attack9Down", "Attack9IS", "Attack9ISUp", "Attack9ISDown",
+		"AttackThrow6", "AttackThrow6Up", "AttackThrow6Down", "AttackThrow6IS", "AttackThrow6ISUp", "AttackThrow6ISDown",
+		"AttackThrow7", "AttackThrow7Up", "AttackThrow7Down", "AttackThrow7IS", "AttackThrow7ISUp", "AttackThrow7ISDown",
+		"AttackThrow8", "AttackThrow8Up", "AttackThrow8Down", "AttackThrow8IS", "AttackThrow8ISUp", "AttackThrow8ISDown",
+		"Counter", "stomp", "BlockIdle", "BlockHit", "Recoil", "ReloadWStart",
+		"ReloadXStart", "ReloadYStart", "ReloadZStart", "ReloadA", "ReloadB", "ReloadC",
+		"ReloadD", "ReloadE", "ReloadF", "ReloadG", "ReloadH", "ReloadI",
+		"ReloadJ", "ReloadK", "ReloadL", "ReloadM", "ReloadN", "ReloadO",
+		"ReloadP", "ReloadQ", "ReloadR", "ReloadS", "ReloadW", "ReloadX",
+		"ReloadY", "ReloadZ", "JamA", "JamB", "JamC", "JamD",
+		"JamE", "JamF", "JamG", "JamH", "JamI", "JamJ",
+		"JamK", "JamL", "JamM", "JamN", "JamO", "JamP",
+		"JamQ", "JamR", "JamS", "JamW", "JamX", "JamY",
+		"JamZ", "Stagger", "Death", "Talking", "PipBoy", "JumpStart",
+		"JumpLoop", "JumpLand", "HandGrip1", "HandGrip2", "HandGrip3", "HandGrip4",
+		"HandGrip5", "HandGrip6", "JumpLoopForward", "JumpLoopBackward", "JumpLoopLeft", "JumpLoopRight",
+		"PipBoyChild", "JumpLandForward", "JumpLandBackward", "JumpLandLeft", "JumpLandRight",
+	};
+
+	// index + 1 is the move type (kAnimMoveType_Walking has no prefix)
+	constexpr std::array<std::string_view, 3> kMoveTypePrefixes = { "sneak", "swim", "fly" };
+
+	// index + 1 is the hand type, "mt" is kAnimHandType_None
+	constexpr std::array<std::string_view, 11> kHandTypePrefixes =
+	{
+		"h2h", "1hm", "2hm", "1hp", "2hr", "2ha", "2hh", "2hl", "1gt", "1md", "1lm"
+	};
+
+	namespace detail
+	{
+		constexpr char ToLower(const char c)
+		{
+			return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+		}
+
+		constexpr bool EqualsCI(std::string_view left, std::string_view right)
+		{
+			if (left.size() != right.size())
+				return false;
+			for (size_t i = 0; i < left.size(); ++i)
+			{
+				if (ToLower(left[i]) != ToLower(right[i]))
+					return false;
+			}
+			return true;
+		}
+
+		constexpr bool StartsWithCI(std::string_view str, std::string_view prefix)
+		{
+			return !prefix.empty() && str.size() >= prefix.size() && EqualsCI(str.substr(0, prefix.size()), prefix);
+		}
+
+		// same as sv::hash_ci, repeated so that this header doesn't pull in utility.h and builds on its own in
+		// anim_group_names_test.cpp
+		constexpr UInt64 HashCI(std::string_view str)
+		{
+			UInt64 hash = 0xCBF29CE484222325ull;
+			for (const char c : str)
+			{
+				hash ^= static_cast<unsigned char>(ToLower(c));
+				hash *= 0x100000001B3ull;
+			}
+			return hash;
+		}
+
+		// multiplicative hash over HashCI, multiplier picked offline so that every vanilla name lands in its own slot
+		constexpr UInt32 kSlotBits = 12;
+		constexpr UInt64 kSlotMultiplier = 0x9E3779B97F4A80F5ull;
+
+		constexpr UInt32 GetSlot(std::string_view name)
+		{
+			return static_cast<UInt32>((HashCI(name) * kSlotMultiplier) >> (64 - kSlotBits));
+		}
+
+		struct SlotTable
+		{
+			std::array<UInt8, 1 << kSlotBits> groupIds{};
+			bool hasCollision = false;
+		};
+
+		constexpr SlotTable BuildSlotTable()
+		{
+			SlotTable table;
+			for (auto& groupId : table.groupIds)
+				groupId = kInvalidGroupId;
+			for (size_t i = 0; i < kGroupNames.size(); ++i)
+			{
+				auto& slot = table.groupIds[GetSlot(kGroupNames[i])];
+				if (slot != kInvalidGroupId)
+					table.hasCollision = true;
+				slot = static_cast<UInt8>(i);
+			}
+			return table;
+		}
+
+		constexpr SlotTable kSlotTable = BuildSlotTable();
+		static_assert(!kSlotTable.hasCollision, "anim group name hash is no longer perfect, pick a new kSlotMultiplier");
+	}
+
+	// returns kInvalidGroupId if name is not an exact (case insensitive) group name
+	constexpr UInt8 Find(std::string_view name)
+	{
+		const auto groupId = detail::kSlotTable.groupIds[detail::GetSlot(name)];
+		if (groupId == kInvalidGroupId || !detail::EqualsCI(kGroupNames[groupId], name))
+			return kInvalidGroupId;
+		return groupId;
+	}
+
+	struct ParsedName
+	{
+		std::string_view baseName;
+		UInt8 moveType = 0;
+		UInt8 handType = 0;
+		bool isPowerArmor = false;
+	};
+
+	// splits "pa" + move type + hand type prefixes off of a file stem, e.g. "sneak2hraim" -> 1, 5, "aim"
+	constexpr ParsedName StripPrefixes(std::string_view name)
+	{
+		ParsedName result;
+		if (detail::StartsWithCI(name, "pa"))
+		{
+			result.isPowerArmor = true;
+			name.remove_prefix(2);
+		}
+		for (size_t i = 0; i < kMoveTypePrefixes.size(); ++i)
+		{
+			if (detail::StartsWithCI(name, kMoveTypePrefixes[i]))
+			{
+				result.moveType = static_cast<UInt8>(i + 1);
+				name.remove_prefix(kMoveTypePrefixes[i].size());
+				break;
+			}
+		}
+		if (detail::StartsWithCI(name, "mt"))
+			name.remove_prefix(2);
+		else
+		{
+			for (size_t i = 0; i < kHandTypePrefixes.size(); ++i)
+			{
+				if (detail::StartsWithCI(name, kHandTypePrefixes[i]))
+				{
+					result.handType = static_cast<UInt8>(i + 1);
+					name.remove_prefix(kHandTypePrefixes[i].size());
+					break;
+				}
+			}
+		}
+		result.baseName = name;
+		return result;
+	}
+
+	// group name without "_suffix" or " suffix", e.g. "AttackLeft_1" or "AttackLeft copy"
+	constexpr UInt8 FindSimple(std::string_view name)
+	{
+		if (const auto underscorePos = name.find('_'); underscorePos != std::string_view::npos)
+			name = name.substr(0, underscorePos);
+		if (const auto spacePos = name.find(' '); spacePos != std::string_view::npos)
+			name = name.substr(0, spacePos);
+		return Find(name);
+	}
+
+	static_assert(Find("Idle") == 0);
+	static_assert(Find("attackleftisdown") == 31);
+	static_assert(Find("JumpLandRight") == kGroupNames.size() - 1);
+	static_assert(Find("NotAGroup") == kInvalidGroupId);
+	static_assert(StripPrefixes("pasneak2hraim").baseName == "aim");
+	static_assert(StripPrefixes("pasneak2hraim").moveType == 1 && StripPrefixes("pasneak2hraim").handType == 5);
+	static_assert(StripPrefixes("mtidle").baseName == "idle" && StripPrefixes("mtidle").handType == 0);
+	static_assert(FindSimple("1hpAttackRight_2") == kInvalidGroupId && FindSimple(StripPrefixes("1hpAttackRight_2").baseName) == 32);
+}
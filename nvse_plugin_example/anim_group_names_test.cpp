@@ -0,0 +1,202 @@
+// Standalone test for AnimGroupNames, not part of the plugin build. Find is checked against the group names captured
+// from the engine's AnimGroupInfo table (0x11977D8, same order as AnimGroupID) in every case variant and against a
+// linear search for names that aren't groups; StripPrefixes is checked for every combination of power armor, move
+// type and hand type prefix. Build and run it with any C++20 compiler, e.g.
+//   g++ -std=c++20 -g -fsanitize=address,undefined anim_group_names_test.cpp && ./a.out
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+// stand-ins for what nvse/prefix.h provides in the plugin build
+typedef std::uint8_t UInt8;
+typedef std::uint32_t UInt32;
+typedef std::uint64_t UInt64;
+
+#include "anim_group_names.h"
+
+#define CHECK(cond) \
+	if (!(cond)) \
+	{ \
+		std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		std::abort(); \
+	}
+
+namespace
+{
+	// names as the engine stores them, index is the AnimGroupID
+	const char* const kCapturedNames[] =
+	{
+		"Idle", "DynamicIdle", "SpecialIdle", "Forward", "Backward", "Left",
+		"Right", "FastForward", "FastBackward", "FastLeft", "FastRight", "DodgeForward",
+		"DodgeBack", "DodgeLeft", "DodgeRight", "TurnLeft", "TurnRight", "Aim",
+		"AimUp", "AimDown", "AimIS", "AimISUp", "AimISDown", "Holster",
+		"Equip", "Unequip", "AttackLeft", "AttackLeftUp", "AttackLeftDown", "AttackLeftIS",
+		"AttackLeftISUp", "AttackLeftISDown", "AttackRight", "AttackRightUp", "AttackRightDown", "AttackRightIS",
+		"AttackRightISUp", "AttackRightISDown", "Attack3", "Attack3Up", "Attack3Down", "Attack3IS",
+		"Attack3ISUp", "Attack3ISDown", "Attack4", "Attack4Up", "Attack4Down", "Attack4IS",
+		"Attack4ISUp", "Attack4ISDown", "Attack5", "Attack5Up", "Attack5Down", "Attack5IS",
+		"Attack5ISUp", "Attack5ISDown", "Attack6", "Attack6Up", "Attack6Down", "Attack6IS",
+		"Attack6ISUp", "Attack6ISDown", "Attack7", "Attack7Up", "Attack7Down", "Attack7IS",
+		"Attack7ISUp", "Attack7ISDown", "Attack8", "Attack8Up", "Attack8Down", "Attack8IS",
+		"Attack8ISUp", "Attack8ISDown", "AttackLoop", "AttackLoopUp", "AttackLoopDown", "AttackLoopIS",
+		"AttackLoopISUp", "AttackLoopISDown", "AttackSpin", "AttackSpinUp", "AttackSpinDown", "AttackSpinIS",
+		"AttackSpinISUp", "AttackSpinISDown", "AttackSpin2", "AttackSpin2Up", "AttackSpin2Down", "AttackSpin2IS",
+		"AttackSpin2ISUp", "AttackSpin2ISDown", "AttackPower", "AttackForwardPower", "AttackBackPower", "AttackLeftPower",
+		"AttackRightPower", "AttackCustom1Power", "AttackCustom2Power", "AttackCustom3Power", "AttackCustom4Power", "AttackCustom5Power",
+		"PlaceMine", "PlaceMineUp", "PlaceMineDown", "PlaceMineIS", "PlaceMineISUp", "PlaceMineISDown",
+		"PlaceMine2", "PlaceMine2Up", "PlaceMine2Down", "PlaceMine2IS", "PlaceMine2ISUp", "PlaceMine2ISDown",
+		"AttackThrow", "AttackThrowUp", "AttackThrowDown", "AttackThrowIS", "AttackThrowISUp", "AttackThrowISDown",
+		"AttackThrow2", "AttackThrow2Up", "AttackThrow2Down", "AttackThrow2IS", "AttackThrow2ISUp", "AttackThrow2ISDown",
+		"AttackThrow3", "AttackThrow3Up", "AttackThrow3Down", "AttackThrow3IS", "AttackThrow3ISUp", "AttackThrow3ISDown",
+		"AttackThrow4", "AttackThrow4Up", "AttackThrow4Down", "AttackThrow4IS", "AttackThrow4ISUp", "AttackThrow4ISDown",
+		"AttackThrow5", "AttackThrow5Up", "AttackThrow5Down", "AttackThrow5IS", "AttackThrow5ISUp", "AttackThrow5ISDown",
+		"Attack9", "Attack9Up", "Attack9Down", "Attack9IS", "Attack9ISUp", "Attack9ISDown",
+		"AttackThrow6", "AttackThrow6Up", "AttackThrow6Down", "AttackThrow6IS", "AttackThrow6ISUp", "AttackThrow6ISDown",
+		"AttackThrow7", "AttackThrow7Up", "AttackThrow7Down", "AttackThrow7IS", "AttackThrow7ISUp", "AttackThrow7ISDown",
+		"AttackThrow8", "AttackThrow8Up", "AttackThrow8Down", "AttackThrow8IS", "AttackThrow8ISUp", "AttackThrow8ISDown",
+		"Counter", "stomp", "BlockIdle", "BlockHit", "Recoil", "ReloadWStart",
+		"ReloadXStart", "ReloadYStart", "ReloadZStart", "ReloadA", "ReloadB", "ReloadC",
+		"ReloadD", "ReloadE", "ReloadF", "ReloadG", "ReloadH", "ReloadI",
+		"ReloadJ", "ReloadK", "ReloadL", "ReloadM", "ReloadN", "ReloadO",
+		"ReloadP", "ReloadQ", "ReloadR", "ReloadS", "ReloadW", "ReloadX",
+		"ReloadY", "ReloadZ", "JamA", "JamB", "JamC", "JamD",
+		"JamE", "JamF", "JamG", "JamH", "JamI", "JamJ",
+		"JamK", "JamL", "JamM", "JamN", "JamO", "JamP",
+		"JamQ", "JamR", "JamS", "JamW", "JamX", "JamY",
+		"JamZ", "Stagger", "Death", "Talking", "PipBoy", "JumpStart",
+		"JumpLoop", "JumpLand", "HandGrip1", "HandGrip2", "HandGrip3", "HandGrip4",
+		"HandGrip5", "HandGrip6", "JumpLoopForward", "JumpLoopBackward", "JumpLoopLeft", "JumpLoopRight",
+		"PipBoyChild", "JumpLandForward", "JumpLandBackward", "JumpLandLeft", "JumpLandRight",
+	};
+
+	std::string Lower(std::string_view str)
+	{
+		std::string result(str);
+		for (auto& c : result)
+			c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+		return result;
+	}
+
+	std::string Upper(std::string_view str)
+	{
+		std::string result(str);
+		for (auto& c : result)
+			c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+		return result;
+	}
+
+	// flips the case of every other letter so that neither the engine's case nor a uniform one is passed
+	std::string Alternate(std::string_view str)
+	{
+		std::string result(str);
+		for (size_t i = 0; i < result.size(); i += 2)
+		{
+			const auto c = static_cast<unsigned char>(result[i]);
+			result[i] = static_cast<char>(std::islower(c) ? std::toupper(c) : std::tolower(c));
+		}
+		return result;
+	}
+
+	UInt8 LinearFind(std::string_view name)
+	{
+		static const auto lowerNames = []
+		{
+			std::vector<std::string> result;
+			for (const auto* capturedName : kCapturedNames)
+				result.push_back(Lower(capturedName));
+			return result;
+		}();
+		const auto lowerName = Lower(name);
+		for (size_t i = 0; i < lowerNames.size(); ++i)
+		{
+			if (lowerNames[i] == lowerName)
+				return static_cast<UInt8>(i);
+		}
+		return AnimGroupNames::kInvalidGroupId;
+	}
+
+	void TestFind()
+	{
+		CHECK(std::size(kCapturedNames) == AnimGroupNames::kGroupNames.size());
+		for (size_t i = 0; i < std::size(kCapturedNames); ++i)
+		{
+			const std::string_view name = kCapturedNames[i];
+			CHECK(AnimGroupNames::Find(name) == i);
+			CHECK(AnimGroupNames::Find(Lower(name)) == i);
+			CHECK(AnimGroupNames::Find(Upper(name)) == i);
+			CHECK(AnimGroupNames::Find(Alternate(name)) == i);
+			CHECK(AnimGroupNames::FindSimple(std::string(name) + "_2") == i);
+			CHECK(AnimGroupNames::FindSimple(std::string(name) + " copy") == i);
+
+			// truncated, extended and prefixed names must not resolve to this group
+			CHECK(AnimGroupNames::Find(name.substr(0, name.size() - 1)) == LinearFind(name.substr(0, name.size() - 1)));
+			CHECK(AnimGroupNames::Find(std::string(name) + "x") == LinearFind(std::string(name) + "x"));
+			CHECK(AnimGroupNames::Find("1hp" + std::string(name)) == AnimGroupNames::kInvalidGroupId);
+			CHECK(AnimGroupNames::Find(std::string(name) + "_2") == AnimGroupNames::kInvalidGroupId);
+		}
+		for (const auto* name : { "", "a", "NotAGroup", "Idle2", "AttackLeftISDownUp", "Reload", "Jam", "Attack10", "mtidle" })
+			CHECK(AnimGroupNames::Find(name) == AnimGroupNames::kInvalidGroupId);
+
+		// names that land in the slot of a group without being it
+		std::mt19937 rng(1);
+		const std::string_view alphabet = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_ ";
+		for (int i = 0; i < 200000; ++i)
+		{
+			std::string name(1 + rng() % 20, ' ');
+			for (auto& c : name)
+				c = alphabet[rng() % alphabet.size()];
+			CHECK(AnimGroupNames::Find(name) == LinearFind(name));
+		}
+	}
+
+	void TestStripPrefixes()
+	{
+		std::vector<std::string_view> moveTypes = { "" };
+		moveTypes.insert(moveTypes.end(), AnimGroupNames::kMoveTypePrefixes.begin(), AnimGroupNames::kMoveTypePrefixes.end());
+		std::vector<std::string_view> handTypes = { "", "mt" };
+		handTypes.insert(handTypes.end(), AnimGroupNames::kHandTypePrefixes.begin(), AnimGroupNames::kHandTypePrefixes.end());
+
+		for (size_t groupId = 0; groupId < std::size(kCapturedNames); ++groupId)
+		{
+			for (const bool isPowerArmor : { false, true })
+			{
+				for (size_t moveType = 0; moveType < moveTypes.size(); ++moveType)
+				{
+					for (size_t hand = 0; hand < handTypes.size(); ++hand)
+					{
+						const auto name = std::string(isPowerArmor ? "pa" : "") + std::string(moveTypes[moveType]) + std::string(handTypes[hand]) + kCapturedNames[groupId];
+						// "mt" is no hand type, the others are their index in kHandTypePrefixes + 1
+						const UInt8 handType = hand < 2 ? 0 : static_cast<UInt8>(hand - 1);
+						for (const auto& variant : { name, Lower(name), Upper(name), Alternate(name) })
+						{
+							const auto parsed = AnimGroupNames::StripPrefixes(variant);
+							CHECK(parsed.isPowerArmor == isPowerArmor);
+							CHECK(parsed.moveType == moveType);
+							CHECK(parsed.handType == handType);
+							CHECK(Lower(parsed.baseName) == Lower(kCapturedNames[groupId]));
+							CHECK(AnimGroupNames::Find(parsed.baseName) == groupId);
+							CHECK(AnimGroupNames::FindSimple(AnimGroupNames::StripPrefixes(variant + "_1").baseName) == groupId);
+						}
+					}
+				}
+			}
+		}
+
+		// nothing to strip
+		const auto parsed = AnimGroupNames::StripPrefixes("NotAGroup");
+		CHECK(parsed.baseName == "NotAGroup" && !parsed.isPowerArmor && parsed.moveType == 0 && parsed.handType == 0);
+	}
+}
+
+int main()
+{
+	TestFind();
+	TestStripPrefixes();
+	std::puts("AnimGroupNames passed");
+	return 0;
+}
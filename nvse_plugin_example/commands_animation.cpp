@@ -13,16 +13,19 @@
 #include "GameObjects.h"
 #include "GameRTTI.h"
 #include "hooks.h"
+#include "kf_model_cache.h"
 #include "main.h"
 #include "MemoizedMap.h"
 #include "utility.h"
 #include "PluginAPI.h"
 #include "stack_allocator.h"
+#include "timer_wheel.h"
 #include <cassert>
 #include <shared_mutex>
 
 #include "additive_anims.h"
 #include "anim_fixes.h"
+#include "anim_group_names.h"
 #include "blend_fixes.h"
 #include "nihooks.h"
 #include "NiNodes.h"
@@ -119,9 +122,62 @@ BSAnimGroupSequence* GetAnimationByPath(const char* path)
 	return kfModel ? kfModel->controllerSequence : nullptr;
 }
 
-// intentional const char*, anim paths are pooled and their pointers remain consistent throughout lifetime
-std::unordered_map<std::pair<const char*, AnimData*>, BSAnimationContext, pair_hash, pair_equal> g_cachedAnimMap;
+AnimDataCustomAnimsMap g_animDataCustomAnims;
 
+std::shared_ptr<AnimDataCustomAnims> AnimDataCustomAnimsMap::Get(AnimData* animData)
+{
+	auto& shard = GetShard(animData);
+	std::shared_lock lock(shard.mutex);
+	if (const auto iter = shard.map.find(animData); iter != shard.map.end())
+		return iter->second;
+	return nullptr;
+}
+
+std::shared_ptr<AnimDataCustomAnims> AnimDataCustomAnimsMap::GetOrCreate(AnimData* animData)
+{
+	if (auto customAnims = Get(animData))
+		return customAnims;
+	auto& shard = GetShard(animData);
+	std::unique_lock lock(shard.mutex);
+	auto& customAnims = shard.map[animData];
+	if (!customAnims)
+		customAnims = std::make_shared<AnimDataCustomAnims>();
+	return customAnims;
+}
+
+void AnimDataCustomAnimsMap::Erase(AnimData* animData)
+{
+	std::shared_ptr<AnimDataCustomAnims> customAnims;
+	{
+		auto& shard = GetShard(animData);
+		std::unique_lock lock(shard.mutex);
+		const auto iter = shard.map.find(animData);
+		if (iter == shard.map.end())
+			return;
+		customAnims = std::move(iter->second);
+		shard.map.erase(iter);
+	}
+	// waits for a bind that is already running, later ones see the flag; whoever drops the last reference frees it
+	std::unique_lock lock(customAnims->mutex);
+	customAnims->erased = true;
+	for (const auto& [path, binding] : customAnims->anims)
+		g_kfModelCache.ReleaseBinding(path, binding.size);
+	customAnims->anims.clear();
+}
+
+void AnimDataCustomAnimsMap::Clear()
+{
+	for (auto& shard : shards)
+	{
+		std::unique_lock lock(shard.mutex);
+		for (const auto& customAnims : shard.map | std::views::values)
+		{
+			std::unique_lock customAnimsLock(customAnims->mutex);
+			customAnims->erased = true;
+		}
+		shard.map.clear();
+	}
+}
 
 #if _DEBUG
 NiTPointerMap_t<const char*, NiAVObject*>::Entry entry;
@@ -135,46 +191,63 @@ NiTPointerMap_t<const char*, NiAVObject*>::Entry entry;
  * After a call to DeleteAnimSequence it will be reduced to 1, only KFModel reference persists and is reused next time
  * when LoadAnimation is called.
  */
-std::shared_mutex g_loadCustomAnimationMutex;
 
 void HandleOnAnimDataDelete(AnimData* animData)
 {
 	const auto actorId = animData->actor ? animData->actor->refID : 0;
-	if (actorId)
 	{
 		std::unique_lock lock(g_animTimeMutex);
-		std::erase_if(g_timeTrackedAnims, _L(auto& p, p.second->actorId == actorId));
-		std::erase_if(g_burstFireQueue, _L(auto& p, p.actorId == actorId));
+		if (actorId)
+		{
+			for (auto* anim : g_timeTrackedAnimOwners.Take(actorId))
+				g_timeTrackedAnims.erase(anim);
+		}
+		g_burstFireScheduler.EraseOwnedBy(animData, actorId);
 	}
 	
 	{
 		std::unique_lock lock(g_pollConditionMutex);
-		std::erase_if(g_timeTrackedGroups, _L(auto & iter, iter.second->animData == animData));
-	}
-	
-	{
-		std::unique_lock lock(g_loadCustomAnimationMutex);
-		std::erase_if(g_cachedAnimMap, _L(auto& p, p.first.second == animData));
+		for (const auto& key : g_timeTrackedGroupOwners.Take(animData))
+			g_timeTrackedGroups.erase(key);
 	}
+
+	g_queuedReplaceAnims.EraseAnimData(animData);
+
+	g_animDataCustomAnims.Erase(animData);
 }
 
 thread_local GameAnimMap* s_customMap = nullptr;
 
 std::optional<BSAnimationContext> LoadCustomAnimation(std::string_view path, AnimData* animData)
 {
-	const auto key = std::make_pair(path.data(), animData);
+	if (!animData)
+		return std::nullopt;
+	// keeps customAnims alive should the AnimData be erased while this runs
+	const auto customAnimsRef = g_animDataCustomAnims.GetOrCreate(animData);
+	auto& customAnims = *customAnimsRef;
+	const auto findCached = [&]() -> std::optional<BSAnimationContext>
+	{
+		if (const auto iter = customAnims.anims.find(path.data()); iter != customAnims.anims.end())
+		{
+			iter->second.lastUsedFrame = g_kfModelCache.CurrentFrame();
+			return iter->second.context;
+		}
+		return std::nullopt;
+	};
 	{
-		std::shared_lock lock(g_loadCustomAnimationMutex);
-		if (const auto iter = g_cachedAnimMap.find(key); iter != g_cachedAnimMap.end())
+		const auto lock = SharedLockCounted(customAnims.mutex, g_lockContentionCounters.customAnimLookup);
+		if (auto cached = findCached())
 		{
-			return iter->second;
+			++g_kfModelCache.stats.hits;
+			return cached;
 		}
 	}
+	++g_kfModelCache.stats.misses;
 
 	const auto tryCreateAnimation = [&]() -> std::optional<BSAnimationContext>
 	{
-		auto* kfModel = ModelLoader::LoadKFModel(path.data());
-		if (kfModel && kfModel->animGroup && animData)
+		auto* kfModel = g_kfModelCache.Get(path.data());
+		if (kfModel && kfModel->animGroup)
 		{
 			const auto groupId = kfModel->animGroup->groupID;
 
@@ -197,8 +270,11 @@ std::optional<BSAnimationContext> LoadCustomAnimation(std::string_view path, Ani
 					BSAnimGroupSequence* anim;
 					if (base && ((anim = base->GetSequenceByIndex(-1))))
 					{
-						auto iter = g_cachedAnimMap.emplace(key, BSAnimationContext(anim, base));
-						return iter.first->second;
+						const auto bindingSize = KFModelCache::EstimateBindingSize(anim);
+						auto iter = customAnims.anims.try_emplace(path.data(), BSAnimationContext(anim, base), bindingSize, g_kfModelCache.CurrentFrame());
+						if (iter.second)
+							g_kfModelCache.AddBinding(path.data(), bindingSize);
+						return iter.first->second.context;
 					}
 					ERROR_LOG("Map returned null anim " + std::string(path));
 				}
@@ -213,7 +289,12 @@ std::optional<BSAnimationContext> LoadCustomAnimation(std::string_view path, Ani
 		return std::nullopt;
 	};
 
-	std::unique_lock lock(g_loadCustomAnimationMutex);
+	// only binds to the same AnimData are serialized, the scratch map is per thread
+	auto lock = LockCounted(customAnims.mutex, g_lockContentionCounters.customAnimBind);
+	if (auto cached = findCached())
+		return cached;
+	if (customAnims.erased)
+		return std::nullopt;
 	auto* defaultMap = animData->mapAnimSequenceBase;
 
 	if (!s_customMap)
@@ -236,10 +317,7 @@ std::optional<BSAnimationContext> LoadCustomAnimation(SavedAnims& animBundle, UI
 {
 	if (const auto* animPath = GetAnimPath(animBundle, groupId, animData))
 	{
-		const auto animCtx = LoadCustomAnimation(animPath->path, animData);
-		if (animCtx)
-			animBundle.linkedSequences.insert(animCtx->anim);
-		return animCtx;
+		return LoadCustomAnimation(animPath->path, animData);
 	}
 	return std::nullopt;
 }
@@ -258,7 +336,7 @@ AnimTime::~AnimTime()
 }
 
 // Make sure that Aim, AimUp and AimDown all use the same index
-AnimPath* HandleAimUpDownRandomness(UInt32 animGroupId, std::vector<AnimPath*>& anims)
+std::optional<UInt32> HandleAimUpDownRandomness(UInt32 animGroupId, UInt32 numAnims)
 {
 	UInt32 baseId;
 	if (const auto animGroupMinor = animGroupId & 0xFF; animGroupMinor >= kAnimGroup_Aim && animGroupMinor <= kAnimGroup_AimISDown && (baseId = kAnimGroup_Aim)
@@ -266,26 +344,217 @@ AnimPath* HandleAimUpDownRandomness(UInt32 animGroupId, std::vector<AnimPath*>&
 		|| animGroupMinor >= kAnimGroup_PlaceMine && animGroupMinor <= kAnimGroup_AttackThrow8ISDown && (baseId = kAnimGroup_PlaceMine))
 	{
 		static unsigned int s_lastRandomId = 0;
-		if ((animGroupMinor - baseId) % 3 == 0 || s_lastRandomId >= anims.size())
-			s_lastRandomId = GetRandomUInt(anims.size());
+		if ((animGroupMinor - baseId) % 3 == 0 || s_lastRandomId >= numAnims)
+			s_lastRandomId = GetRandomUInt(numAnims);
 
-		return anims.at(s_lastRandomId);
+		return s_lastRandomId;
 	}
-	return nullptr;
+	return std::nullopt;
 }
 
-std::list<BurstFireData> g_burstFireQueue;
+BurstFireScheduler g_burstFireScheduler;
+
+float BurstFireData::GetNextDueTime() const
+{
+	auto dueTime = FLT_MAX;
+	if (const auto hitTimes = keyTimes->HitTimes(); hitIdx < hitTimes.size())
+		dueTime = hitTimes[hitIdx];
+	if (const auto ejectTimes = keyTimes->EjectTimes(); ejectIdx < ejectTimes.size())
+		dueTime = min(dueTime, ejectTimes[ejectIdx]);
+	// first hit handled by engine, don't want duplicated shootings
+	return max(dueTime, anim->animGroup->keyTimes[kSeqState_HitOrDetach]);
+}
+
+bool BurstFireData::IsDone() const
+{
+	return hitIdx >= keyTimes->HitTimes().size() && ejectIdx >= keyTimes->EjectTimes().size();
+}
+
+std::shared_ptr<const BurstFireKeyTimes> BurstFireScheduler::GetKeyTimes(BSAnimGroupSequence* anim)
+{
+	auto* textKeyData = anim->m_spTextKeys.data;
+	if (!textKeyData)
+		return nullptr;
+	const auto textKeys = textKeyData->GetKeys();
+	const auto iter = keyTimesCache.find(textKeyData);
+	if (iter != keyTimesCache.end() && iter->second->keys == textKeys.data() && iter->second->numKeys == textKeys.size())
+		return iter->second;
+
+	// not cached or the keys were changed since, bursts in flight keep the old times alive
+	auto newKeyTimes = std::make_shared<BurstFireKeyTimes>();
+	newKeyTimes->textKeys = textKeyData;
+	newKeyTimes->keys = textKeys.data();
+	newKeyTimes->numKeys = static_cast<UInt32>(textKeys.size());
+	const auto parseForKeys = [&](const char* keyName)
+	{
+		bool skippedFirst = false;
+		for (auto& key : textKeys)
+		{
+			if (_stricmp(key.m_kText.CStr(), keyName) == 0)
+			{
+				if (!skippedFirst)
+				{
+					// engine handles first key
+					skippedFirst = true;
+					continue;
+				}
+				newKeyTimes->times.push_back(key.m_fTime);
+			}
+		}
+	};
+	parseForKeys("hit");
+	newKeyTimes->numHitKeys = static_cast<UInt32>(newKeyTimes->times.size());
+	parseForKeys("eject");
+	// nothing to schedule, not cached since no burst would ever drop it
+	if (newKeyTimes->times.empty())
+		return nullptr;
+	keyTimesCache[textKeyData] = newKeyTimes;
+	return newKeyTimes;
+}
+
+void BurstFireScheduler::Add(AnimData* animData, BSAnimGroupSequence* anim)
+{
+	auto keyTimes = GetKeyTimes(anim);
+	if (!keyTimes)
+		return;
+	auto& burst = bursts.emplace_back();
+	burst.anim = anim;
+	burst.animData = animData;
+	burst.actorId = animData->actor->refID;
+	burst.keyTimes = std::move(keyTimes);
+	++numBurstsByActor[burst.actorId];
+	burst.nextDueTime = burst.GetNextDueTime();
+	peakActive = std::max<UInt32>(peakActive, bursts.size());
+}
+
+void BurstFireScheduler::Remove(size_t index)
+{
+	// last burst using the cached times, the cache holds the only other reference
+	if (const auto& keyTimes = bursts[index].keyTimes; keyTimes.use_count() == 2)
+	{
+		if (const auto iter = keyTimesCache.find(keyTimes->textKeys.data); iter != keyTimesCache.end() && iter->second == keyTimes)
+			keyTimesCache.erase(iter);
+	}
+	if (const auto iter = numBurstsByActor.find(bursts[index].actorId); iter != numBurstsByActor.end() && --iter->second == 0)
+		numBurstsByActor.erase(iter);
+	if (index != bursts.size() - 1)
+		bursts[index] = std::move(bursts.back());
+	bursts.pop_back();
+}
+
+void BurstFireScheduler::Clear()
+{
+	bursts.clear();
+	keyTimesCache.clear();
+	numBurstsByActor.clear();
+}
+
+void BurstFireScheduler::EraseOwnedBy(AnimData* animData, UInt32 actorId)
+{
+	// every burst of an AnimData with an actor is counted under that actor
+	if (actorId && !numBurstsByActor.contains(actorId))
+		return;
+	EraseIf(_L(const BurstFireData& p, p.animData == animData || actorId && p.actorId == actorId));
+}
+
+void BurstFireScheduler::Update()
+{
+	std::unique_lock lock(g_animTimeMutex);
+	// iterate by index, firing or ejecting may start new bursts on this thread
+	for (size_t i = 0; i < bursts.size();)
+	{
+		auto& burst = bursts[i];
+		auto* anim = burst.anim.data;
+		if (!anim || !anim->animGroup || burst.animData->animSequence[kSequence_Weapon] != anim
+			|| anim->m_fLastScaledTime - burst.lastNiTime < -0.01f && anim->m_eCycleType != NiControllerSequence::LOOP)
+		{
+			Remove(i);
+			continue;
+		}
+		burst.lastNiTime = anim->m_fLastScaledTime;
+		const auto timePassed = anim->m_fLastScaledTime;
+		if (timePassed <= burst.nextDueTime)
+		{
+			++i;
+			continue;
+		}
+		auto* actor = DYNAMIC_CAST(LookupFormByRefID(burst.actorId), TESForm, Actor);
+		if (!actor || actor->IsDeleted() || actor->IsDead(true))
+		{
+			Remove(i);
+			continue;
+		}
+		auto* animData = burst.animData;
+		auto* weapon = actor->GetWeaponForm();
+		const auto hitTimes = burst.keyTimes->HitTimes();
+		const auto ejectTimes = burst.keyTimes->EjectTimes();
+		const auto passedHitKey = burst.hitIdx < hitTimes.size() && timePassed > hitTimes[burst.hitIdx];
+		const auto passedEjectKey = burst.ejectIdx < ejectTimes.size() && timePassed > ejectTimes[burst.ejectIdx];
+		if (passedHitKey || passedEjectKey)
+		{
+			if (auto* ammoInfo = actor->baseProcess->GetAmmoInfo()) // static_cast<Decoding::MiddleHighProcess*>(animData->actor->baseProcess)->ammoInfo
+			{
+				if (!IsGodMode())
+				{
+					if (ammoInfo->count == 0 || actor->IsAnimActionReload())
+					{
+						// reloaded
+						burst.reloading = true;
+					}
+				}
+			}
+			if (passedHitKey)
+				++burst.hitIdx;
+			if (!IsPlayersOtherAnimData(animData))
+			{
+				const auto reloading = burst.reloading;
+				const auto ejectedAll = burst.ejectIdx == ejectTimes.size();
+				bool ejected = false;
+				if (passedHitKey)
+				{
+					if (!reloading)
+						actor->FireWeapon();
+					if (!passedEjectKey && ejectTimes.empty() || ejectedAll)
+					{
+						if (!reloading)
+							actor->EjectFromWeapon(weapon);
+						ejected = true;
+					}
+				}
+				if (!ejected && passedEjectKey)
+				{
+					actor->EjectFromWeapon(weapon);
+					++bursts[i].ejectIdx;
+				}
+			}
+		}
+
+		// FireWeapon may have added bursts and reallocated the pool
+		auto& updated = bursts[i];
+		if (updated.IsDone())
+		{
+			Remove(i);
+			continue;
+		}
+		updated.nextDueTime = updated.GetNextDueTime();
+		++i;
+	}
+}
 
 TimeTrackedAnimsMap g_timeTrackedAnims;
 TimeTrackedGroupsMap g_timeTrackedGroups;
+OwnerIndex<UInt32, BSAnimGroupSequence*> g_timeTrackedAnimOwners;
+OwnerIndex<AnimData*, TimeTrackedGroupsKey> g_timeTrackedGroupOwners;
 
 void EraseTimeTrackedAnim(BSAnimGroupSequence* anim)
 {
 	std::unique_lock lock(g_animTimeMutex);
-	std::erase_if(g_timeTrackedAnims, [anim](const auto& p)
+	// entries are keyed by their own anim
+	if (const auto iter = g_timeTrackedAnims.find(anim); iter != g_timeTrackedAnims.end())
 	{
-		return p.second->anim == anim;
-	});
+		g_timeTrackedAnimOwners.Remove(iter->second->actorId, anim);
+		g_timeTrackedAnims.erase(iter);
+	}
 }
 
 enum class KeyCheckType
@@ -320,6 +589,8 @@ AnimTime* HandleExtraOperations(AnimData* animData, BSAnimGroupSequence* anim, b
 		{
 			const auto iter = g_timeTrackedAnims.emplace(anim, std::make_unique<AnimTime>(actor, anim));
 			animTimePtr = iter.first->second.get();
+			if (iter.second)
+				g_timeTrackedAnimOwners.Add(actor->refID, anim);
 		}
 		return *animTimePtr;
 	};
@@ -328,6 +599,7 @@ AnimTime* HandleExtraOperations(AnimData* animData, BSAnimGroupSequence* anim, b
 		if (!baseAnim)
 		{
 			// idle anims are destroyed after they are done playing, so we can't rely on their pointers being the same in the map
+			// not through the cache, this runs for vanilla anims too; custom ones resolve to the model the cache holds
 			auto* kfModel = ModelLoader::LoadKFModel(anim->m_kName.CStr());
 			if (kfModel)
 				baseAnim = kfModel->controllerSequence;
@@ -369,33 +641,7 @@ AnimTime* HandleExtraOperations(AnimData* animData, BSAnimGroupSequence* anim, b
 	};
 
 	if (anim->animGroup && anim->animGroup->IsAttack() && hasKey({"burstFire"}))
-	{
-		std::vector<NiTextKey*> hitKeys;
-		std::vector<NiTextKey*> ejectKeys;
-		const auto parseForKeys = [&](const char* keyName, std::vector<NiTextKey*>& keys)
-		{
-			bool skippedFirst = false;
-			for (auto& key : textKeys)
-			{
-				if (_stricmp(key.m_kText.CStr(), keyName) == 0)
-				{
-					if (!skippedFirst)
-					{
-						// engine handles first key
-						skippedFirst = true;
-						continue;
-					}
-					keys.push_back(&key);
-				}
-			}
-		};
-		parseForKeys("hit", hitKeys);
-		parseForKeys("eject", ejectKeys);
-		if (!hitKeys.empty() || !ejectKeys.empty())
-		{
-			g_burstFireQueue.emplace_back(animData == g_thePlayer->firstPersonAnimData, anim, 0, std::move(hitKeys), 0.0,false, -FLT_MAX, animData->actor->refID, std::move(ejectKeys), 0, false);
-		}
-	}
+		g_burstFireScheduler.Add(animData, anim);
 	const auto hasRespectEndKey = hasKey({"respectEndKey", "respectTextKeys"});
 	if (animData == g_thePlayer->firstPersonAnimData && anim->animGroup && hasRespectEndKey)
 	{
@@ -528,6 +774,7 @@ AnimTime* HandleExtraOperations(AnimData* animData, BSAnimGroupSequence* anim, b
 	if (applied || createIfNoKeys)
 	{
 		auto& animTime = getAnimTimeStruct();
+		g_timeTrackedAnimOwners.Transfer(animTime.actorId, actor->refID, anim);
 		animTime.actorId = actor->refID;
 		animTime.lastNiTime = -FLT_MAX;
 		animTime.firstPerson = animData == g_thePlayer->firstPersonAnimData;
@@ -539,25 +786,6 @@ AnimTime* HandleExtraOperations(AnimData* animData, BSAnimGroupSequence* anim, b
 
 std::map<std::pair<FormID, SavedAnims*>, int> g_actorAnimOrderMap;
 
-void FilterPartialReloads(std::vector<AnimPath*>& candidates, Actor* actor)
-{
-	const auto didPartialReload = OnReloadHandler::GetLastReloadForActor(actor) == ReloadType::Partial;
-	
-	candidates = candidates | std::views::filter([=](const auto& animPath) {
-		return animPath->partialReload == didPartialReload;
-	}) | std::ranges::to<std::vector>();
-}
-
-void FilterAmmoSwaps(std::vector<AnimPath*>& candidates, Actor* actor)
-{
-	const auto didAmmoSwap = OnReloadHandler::GetLastReloadForActor(actor) == ReloadType::AmmoSwap;
-	
-	candidates = candidates | std::views::filter([=](const auto& animPath)
-	{
-		return animPath->isAmmoSwap == didAmmoSwap;
-	}) | std::ranges::to<std::vector<AnimPath*>>();
-}
-
 std::optional<AnimationResult> PickAnimation(AnimOverrideStruct& overrides, UInt16 groupId, AnimData* animData)
 {
 	if (const auto stacksIter = overrides.stacks.find(groupId); stacksIter != overrides.stacks.end())
@@ -573,9 +801,13 @@ std::optional<AnimationResult> PickAnimation(AnimOverrideStruct& overrides, UInt
 			const auto initAnimTime = [&](SavedAnims* savedAnims)
 			{
 				std::unique_lock lock(g_pollConditionMutex);
-				auto& animTime = g_timeTrackedGroups[std::make_pair(savedAnims, animData)];
+				const auto key = std::make_pair(savedAnims, animData);
+				auto& animTime = g_timeTrackedGroups[key];
 				if (!animTime)
+				{
 					animTime = std::make_unique<SavedAnimsTime>();
+					g_timeTrackedGroupOwners.Add(animData, key);
+				}
 				animTime->conditionScript = *savedAnims->conditionScript;
 				animTime->groupId = groupId;
 				animTime->actorId = animData->actor->refID;
@@ -625,14 +857,13 @@ thread_local AnimPathCache g_animPathFrameCache;
 AnimPath* GetAnimPath(SavedAnims& ctx, UInt16 groupId, AnimData* animData)
 {
 	const auto cacheKey = std::make_pair(&ctx, animData);
-	AnimPath** cachePtr = nullptr;
 	const auto useCache = g_isThreadCacheEnabled;
 	if (useCache)
 	{
-		const auto [result, isNew] = g_animPathFrameCache.emplace(cacheKey, nullptr);
+		const auto [cached, isNew] = g_animPathFrameCache.Emplace(cacheKey);
+		g_mapHitCounters.animPath.Record(!isNew);
 		if (!isNew)
-			return result->second;
-		cachePtr = &result->second;
+			return *cached;
 	}
 
 	if (!ctx.loaded)
@@ -644,9 +875,7 @@ AnimPath* GetAnimPath(SavedAnims& ctx, UInt16 groupId, AnimData* animData)
 	{
 		if (ctx.anims.size() == 1) [[likely]]
 			return ctx.anims[0].get();
-		auto candidates = ctx.anims 
-            | std::views::transform([](const auto& anim) { return anim.get(); }) 
-            | std::ranges::to<std::vector<AnimPath*>>();
+		auto candidates = ctx.allVariants;
 
 		if (groupId == kAnimGroup_DynamicIdle || groupId == kAnimGroup_SpecialIdle)
 		{
@@ -656,11 +885,7 @@ AnimPath* GetAnimPath(SavedAnims& ctx, UInt16 groupId, AnimData* animData)
 			{
 				// handle pip boy dynamic idles
 				const auto queuedFileStem = sv::get_file_stem(idleAnimQueued->m_kName.CStr());
-				candidates = candidates | std::views::filter([=](const auto& animPath)
-				{
-					const auto candidateFileStem = sv::get_file_stem(animPath->path);
-					return sv::equals_ci(candidateFileStem, queuedFileStem);
-				}) | std::ranges::to<std::vector<AnimPath*>>();
+				candidates &= ctx.GetStemVariants(queuedFileStem);
 			}
 		}
 		const auto baseGroupId = static_cast<AnimGroupID>(groupId);
@@ -669,41 +894,40 @@ AnimPath* GetAnimPath(SavedAnims& ctx, UInt16 groupId, AnimData* animData)
 			const auto* groupInfo = GetGroupInfo(baseGroupId);
 			auto* anim = animData->animSequence[groupInfo->sequenceType];
 			const auto useStartAnim = !anim || !anim->animGroup || anim->animGroup->GetBaseGroupID() != baseGroupId;
-			candidates = candidates | std::views::filter([=](const auto& animPath)
-			{
-				return animPath->isStartAnim == useStartAnim;
-			}) | std::ranges::to<std::vector<AnimPath*>>();
+			candidates &= useStartAnim ? ctx.startVariants : ~ctx.startVariants;
 		}
-		if (IsAnimGroupReload(baseGroupId))
+		if (IsAnimGroupReload(baseGroupId) && (ctx.hasAmmoSwap || ctx.hasPartialReload))
 		{
+			const auto lastReload = OnReloadHandler::GetLastReloadForActor(actor);
 			if (ctx.hasAmmoSwap)
-				FilterAmmoSwaps(candidates, actor);
+				candidates &= lastReload == ReloadType::AmmoSwap ? ctx.ammoSwapVariants : ~ctx.ammoSwapVariants;
 			if (ctx.hasPartialReload)
-				FilterPartialReloads(candidates, actor);
+				candidates &= lastReload == ReloadType::Partial ? ctx.partialReloadVariants : ~ctx.partialReloadVariants;
 		}
 
-		if (candidates.empty())
+		const auto numCandidates = static_cast<UInt32>(candidates.count());
+		if (numCandidates == 0)
 			return nullptr;
 		
-		if (candidates.size() == 1)
-			return candidates.front();
+		if (numCandidates == 1)
+			return ctx.GetNthVariant(candidates, 0);
 		
 		if (!ctx.hasOrder)
 		{
 			// Make sure that Aim, AimUp and AimDown all use the same index
-			if (auto* path = HandleAimUpDownRandomness(groupId, candidates))
-				return path;
+			if (const auto index = HandleAimUpDownRandomness(groupId, numCandidates))
+				return ctx.GetNthVariant(candidates, *index);
 			// pick random variant
-			return candidates.at(GetRandomUInt(candidates.size()));
+			return ctx.GetNthVariant(candidates, GetRandomUInt(numCandidates));
 		}
 		
 		// ordered
-		return candidates.at(g_actorAnimOrderMap[std::make_pair(actor->refID, &ctx)]++ % candidates.size());
+		return ctx.GetNthVariant(candidates, g_actorAnimOrderMap[std::make_pair(actor->refID, &ctx)]++ % numCandidates);
 	};
 
 	const auto result = getAnimPath();
 	if (useCache)
-		*cachePtr = result;
+		g_animPathFrameCache.Set(cacheKey, result);
 	return result;
 }
 
@@ -740,14 +964,13 @@ std::optional<AnimationResult> GetActorAnimation(FullAnimGroupID animGroupId, An
 	if (!animData || !animData->actor || !animData->actor->baseProcess)
 		return std::nullopt;
 	const auto cacheKey = std::make_pair(animGroupId, animData);
-	std::optional<AnimationResult>* cachePtr = nullptr;
 	const auto useCache = g_isThreadCacheEnabled;
 	if (useCache)
 	{
-		const auto [result, isNew] = g_animationResultCache.emplace(cacheKey, std::nullopt);
+		const auto [cached, isNew] = g_animationResultCache.Emplace(cacheKey);
+		g_mapHitCounters.getActorAnimation.Record(!isNew);
 		if (!isNew)
-			return result->second;
-		cachePtr = &result->second;
+			return *cached;
 	}
 #if _DEBUG
 	int _debug = 0;
@@ -805,71 +1028,23 @@ std::optional<AnimationResult> GetActorAnimation(FullAnimGroupID animGroupId, An
 	};
 	const auto result = getActorAnimation(animGroupId);
 	if (useCache)
-		*cachePtr = result;
+		g_animationResultCache.Set(cacheKey, result);
 	return result;
 }
 
-std::span<const char*> s_moveTypeNames{ reinterpret_cast<const char**>(0x1197798), 3 };
-std::span<const char*> s_handTypeNames{ reinterpret_cast<const char**>(0x11977A8), 11 };
-
 std::string_view GetBaseAnimGroupName(const std::string_view name)
 {
-	std::string_view oName = name;
-	if (StartsWith(oName, "pa"))
-		oName = oName.substr(2);
-	for (auto* moveTypeName : s_moveTypeNames)
-	{
-		if (StartsWith(oName, moveTypeName))
-		{
-			oName = oName.substr(strlen(moveTypeName));
-			break;
-		}
-	}
-	if (StartsWith(oName, "mt"))
-		oName = oName.substr(2);
-	else
-	{
-		for (auto* handTypeName : s_handTypeNames)
-		{
-			if (StartsWith(oName, handTypeName))
-			{
-				oName = oName.substr(strlen(handTypeName));
-				break;
-			}
-		}
-	}
-
-	return oName;
+	return AnimGroupNames::StripPrefixes(name).baseName;
 }
 
-static std::unordered_map<std::string_view, AnimGroupID, CaseInsensitiveHash, CaseInsensitiveEqual> s_animGroupNameToIDMap;
-
-
 AnimGroupID GroupNameToId(std::string_view name)
 {
-	if (const auto iter = s_animGroupNameToIDMap.find(name); iter != s_animGroupNameToIDMap.end())
-		return iter->second;
-	const auto iter = ra::find_if(g_animGroupInfos, _L(AnimGroupInfo& i, sv::equals_ci(i.name, name)));
-	if (iter == g_animGroupInfos.end())
-		return kAnimGroup_Invalid;
-	const auto groupId = iter - g_animGroupInfos.begin();
-	assert(groupId < kAnimGroup_Max);
-	const auto result = static_cast<AnimGroupID>(groupId);
-	s_animGroupNameToIDMap[std::string_view(iter->name)] = result;
-	return result;
+	return static_cast<AnimGroupID>(AnimGroupNames::Find(name));
 }
 
 AnimGroupID SimpleGroupNameToId(std::string_view name)
 {
-	if (const auto underscorePos = name.find('_'); underscorePos != std::string_view::npos)
-	{
-		name = name.substr(0, underscorePos);
-	}
-	if (const auto spacePos = name.find(' '); spacePos != std::string_view::npos)
-	{
-		name = name.substr(0, spacePos);
-	}
-	return GroupNameToId(name);
+	return static_cast<AnimGroupID>(AnimGroupNames::FindSimple(name));
 }
 
 bool TESAnimGroup::IsLoopingReloadStart() const
@@ -897,19 +1072,18 @@ constexpr UInt16 INVALID_FULL_GROUP_ID = 0xFFFF;
 
 UInt16 GetAnimGroupId(std::string_view path)
 {
-	const auto toFullId = [&](UInt8 groupId)
+	const auto parsed = AnimGroupNames::StripPrefixes(sv::get_file_stem(path));
+	if (const auto id = AnimGroupNames::FindSimple(parsed.baseName); id != AnimGroupNames::kInvalidGroupId)
 	{
+#if _DEBUG
 		int moveType = 0;
 		int animHandType = 0;
 		int isPowerArmor = 0;
 		CdeclCall(0x5F38D0, path.data(), &moveType, &animHandType, &isPowerArmor); // GetMoveHandAndPowerArmorTypeFromAnimName
-		return static_cast<UInt16>(groupId + (moveType << 12) + (isPowerArmor << 15) + (animHandType << 8));
-	};
-	
-	const auto name = sv::get_file_stem(path);
-	const auto baseName = GetBaseAnimGroupName(name);
-	if (const auto id = SimpleGroupNameToId(baseName); id != kAnimGroup_Invalid)
-		return toFullId(id);
+		DebugAssert(moveType == parsed.moveType && animHandType == parsed.handType && isPowerArmor == parsed.isPowerArmor);
+#endif
+		return static_cast<UInt16>(id + (parsed.moveType << 12) + (parsed.isPowerArmor << 15) + (parsed.handType << 8));
+	}
 	
 	// try to load kf model which is slower but if file name is wrong then we have to fall back
 	if (const auto* kfModel = ModelLoader::LoadKFModel(path.data()))
@@ -918,6 +1092,56 @@ UInt16 GetAnimGroupId(std::string_view path)
 	return INVALID_FULL_GROUP_ID;
 }
 
+std::unordered_map<const char*, std::unique_ptr<AnimPathInfo>> g_animPathInfos;
+std::shared_mutex g_animPathInfosMutex;
+
+static FolderConditionType GetFolderConditionType(std::string_view path)
+{
+	const std::pair<const char*, FolderConditionType> folderConditions[] =
+	{
+		{R"(\mod1\)", FolderConditionType::Mod1},
+		{R"(\mod2\)", FolderConditionType::Mod2},
+		{R"(\mod3\)", FolderConditionType::Mod3},
+		{R"(\hurt\)", FolderConditionType::Hurt},
+		{R"(\human\)", FolderConditionType::Human},
+		{R"(\male\)", FolderConditionType::Male},
+		{R"(\female\)", FolderConditionType::Female},
+	};
+	for (const auto& [folder, type] : folderConditions)
+	{
+		if (sv::contains_ci(path, folder))
+			return type;
+	}
+	return FolderConditionType::None;
+}
+
+const AnimPathInfo& InternAnimPath(std::string_view path)
+{
+	{
+		std::shared_lock lock(g_animPathInfosMutex);
+		if (const auto iter = g_animPathInfos.find(path.data()); iter != g_animPathInfos.end())
+			return *iter->second;
+	}
+	const auto pooledPath = AddStringToPool(path);
+	std::unique_lock lock(g_animPathInfosMutex);
+	auto& info = g_animPathInfos[pooledPath.data()];
+	if (!info)
+	{
+		info = std::make_unique<AnimPathInfo>();
+		info->path = pooledPath;
+		info->hash = sv::hash_ci(pooledPath);
+		info->stem = sv::get_file_stem(pooledPath);
+		info->stemHash = sv::hash_ci(info->stem);
+		info->folderConditionType = GetFolderConditionType(pooledPath);
+		if (sv::contains_ci(pooledPath, "_1stperson"))
+			info->pov = POVSwitchState::POV1st;
+		else if (sv::contains_ci(pooledPath, "_male"))
+			info->pov = POVSwitchState::POV3rd;
+		info->groupId = GetAnimGroupId(pooledPath);
+	}
+	return *info;
+}
+
 AnimGroupPathsMap g_customAnimGroupPaths;
 
 std::string_view GetAnimBasePath(std::string_view path)
@@ -931,6 +1155,20 @@ std::string_view GetAnimBasePath(std::string_view path)
 	return "";
 }
 
+// same as above with the POV folder already found when the path was interned
+std::string_view GetAnimBasePath(const AnimPathInfo& pathInfo)
+{
+	switch (pathInfo.pov)
+	{
+	case POVSwitchState::POV1st:
+		return ExtractUntilStringMatches(pathInfo.path, "_1stperson", true);
+	case POVSwitchState::POV3rd:
+		return ExtractUntilStringMatches(pathInfo.path, "_male", true);
+	default:
+		return "";
+	}
+}
+
 std::string_view ExtractCustomAnimGroupName(std::string_view path)
 {
 	const auto stem = sv::get_file_stem(path);
@@ -941,25 +1179,51 @@ std::string_view ExtractCustomAnimGroupName(std::string_view path)
 	return "";
 }
 
-bool RegisterCustomAnimGroupAnim(std::string_view path)
+bool RegisterCustomAnimGroupAnim(const AnimPathInfo& pathInfo)
 {
-	if (!ExtractCustomAnimGroupName(path).empty())
+	if (!ExtractCustomAnimGroupName(pathInfo.path).empty())
 	{
-		const auto basePath = GetAnimBasePath(path);
+		const auto basePath = GetAnimBasePath(pathInfo);
 		if (!basePath.empty())
 		{
-			g_customAnimGroupPaths[std::string(basePath)].insert(std::string(path));
+			g_customAnimGroupPaths[std::string(basePath)].insert(std::string(pathInfo.path));
 			return true;
 		}
 	}
 	return false;
 }
 
+std::function<bool(const Actor*)> GetFolderCondition(FolderConditionType folderConditionType)
+{
+	switch (folderConditionType)
+	{
+	case FolderConditionType::Mod1:
+		return [](const Actor* actor) { return actor->HasWeaponWithMod(kWeaponMod_Flag1); };
+	case FolderConditionType::Mod2:
+		return [](const Actor* actor) { return actor->HasWeaponWithMod(kWeaponMod_Flag2); };
+	case FolderConditionType::Mod3:
+		return [](const Actor* actor) { return actor->HasWeaponWithMod(kWeaponMod_Flag3); };
+	case FolderConditionType::Hurt:
+		return [](const Actor* actor) { return actor->HasCrippledLegs(); };
+	case FolderConditionType::Human:
+		return [](const Actor* actor) { return actor == g_thePlayer || IS_ID(actor->baseForm, TESNPC); };
+	case FolderConditionType::Male:
+		return [](const Actor* actor) { return !actor->IsFemale(); };
+	case FolderConditionType::Female:
+		return [](const Actor* actor) { return actor->IsFemale(); };
+	case FolderConditionType::None:
+	default:
+		return nullptr;
+	}
+}
+
 bool SetOverrideAnimation(AnimOverrideData& data, AnimOverrideMap& map)
 {
+	FunctionTimer timer(&g_averageTimers.setOverrideAnimation);
 	std::unique_lock lock(g_overrideMapMutex);
-	const auto path = data.path;
-	const auto groupId = GetAnimGroupId(path);
+	const auto& pathInfo = InternAnimPath(data.path);
+	const auto path = pathInfo.path;
+	const auto groupId = pathInfo.groupId;
 	if (groupId == INVALID_FULL_GROUP_ID)
 	{
 		ERROR_LOG(FormatString("Failed to resolve file '%s'", path.data()));
@@ -971,7 +1235,7 @@ bool SetOverrideAnimation(AnimOverrideData& data, AnimOverrideMap& map)
 	auto& stack = stacks.anims;
 	const auto findFn = [&](const std::unique_ptr<SavedAnims>& a)
 	{
-		return ra::any_of(a->anims, _L(const auto& s, sv::equals_ci(path, s->path)));
+		return ra::any_of(a->anims, _L(const auto& s, s->info->Equals(pathInfo)));
 	};
 	
 	if (!data.enable)
@@ -999,49 +1263,13 @@ bool SetOverrideAnimation(AnimOverrideData& data, AnimOverrideMap& map)
 		return true;
 	}
 
-	if (RegisterCustomAnimGroupAnim(path))
+	if (RegisterCustomAnimGroupAnim(pathInfo))
 	{
 		// we do not want to add custom anim group anims to the stack or otherwise they'll play
 		return true;
 	}
 
-	auto folderConditionType = FolderConditionType::None;
-	std::function<bool(const Actor*)> folderCondition;
-	if (sv::contains_ci(path, R"(\mod1\)"))
-	{
-		folderConditionType = FolderConditionType::Mod1;
-		folderCondition = [&](const Actor* actor) { return actor->HasWeaponWithMod(kWeaponMod_Flag1); };
-	}
-	else if (sv::contains_ci(path, R"(\mod2\)"))
-	{
-		folderConditionType = FolderConditionType::Mod2;
-		folderCondition = [&](const Actor* actor) { return actor->HasWeaponWithMod(kWeaponMod_Flag2); };
-	}
-	else if (sv::contains_ci(path, R"(\mod3\)"))
-	{
-		folderConditionType = FolderConditionType::Mod3;
-		folderCondition = [&](const Actor* actor) { return actor->HasWeaponWithMod(kWeaponMod_Flag3); };
-	}
-	else if (sv::contains_ci(path, R"(\hurt\)"))
-	{
-		folderConditionType = FolderConditionType::Hurt;
-		folderCondition = [&](const Actor* actor) { return actor->HasCrippledLegs(); };
-	}
-	else if (sv::contains_ci(path, R"(\human\)"))
-	{
-		folderConditionType = FolderConditionType::Human;
-		folderCondition = [&](const Actor* actor) { return actor == g_thePlayer || IS_ID(actor->baseForm, TESNPC); };
-	}
-	else if (sv::contains_ci(path, R"(\male\)"))
-	{
-		folderConditionType = FolderConditionType::Male;
-		folderCondition = [&](const Actor* actor) { return !actor->IsFemale(); };
-	}
-	else if (sv::contains_ci(path, R"(\female\)"))
-	{
-		folderConditionType = FolderConditionType::Female;
-		folderCondition = [&](const Actor* actor) { return actor->IsFemale(); };
-	}
+	const auto folderConditionType = pathInfo.folderConditionType;
 	
 	// if not inserted before, treat as variant; else add to stack as separate set
 	auto [_, newItem] = data.groupIdFillSet.emplace(groupId);
@@ -1050,19 +1278,20 @@ bool SetOverrideAnimation(AnimOverrideData& data, AnimOverrideMap& map)
 	
 	auto& anims = *stack.back();
 
-	if (const auto stem = sv::get_file_stem(path); sv::ends_with_ci(stem, "_additive"))
+	if (sv::ends_with_ci(pathInfo.stem, "_additive"))
 	{
 		anims.additiveAnimPath = path;
 		return true;
 	}
 	
-	anims.anims.emplace_back(std::make_unique<AnimPath>(path));
+	anims.anims.emplace_back(std::make_unique<AnimPath>(AnimPath{ .path = path, .info = &pathInfo }));
+	anims.loaded = false; // rebuild variant masks
 	anims.matchBaseGroupId = data.matchBaseGroupId;
 	anims.conditionScript = data.conditionScript;
 	anims.pollCondition = data.pollCondition;
 	anims.conditionScriptText = data.conditionScriptText;
 	anims.folderConditionType = folderConditionType;
-	anims.folderCondition = std::move(folderCondition);
+	anims.folderCondition = GetFolderCondition(folderConditionType);
 	
 	return true;
 }
@@ -1191,8 +1420,18 @@ int GetWeaponInfoClipSize(Actor* actor)
 	return maxRounds;
 }
 
-std::map<ReloadKey, ReloadHandler> g_reloadMap;
+// reload state only changes in the reload hooks; instead of sweeping every actor each frame, the check whether a
+// reload is over is scheduled on a timer wheel, so ticks without due checks do nothing
+std::unordered_map<FormID, ReloadEventRing> g_reloadEvents;
+// actor ID and tick of the event a check was scheduled for, checks of superseded events are dropped
+TimerWheel<std::pair<FormID, UInt32>> g_reloadExpiryWheel;
 std::shared_mutex g_reloadMapMutex;
+std::atomic<UInt32> g_reloadTick = 0;
+// mirrors g_reloadExpiryWheel.Size() so that ticks without pending checks skip the lock
+std::atomic<UInt32> g_numReloadChecks = 0;
+
+// keeping the state a couple of ticks past the end of a reload is harmless, the next reload pushes a new event anyway
+constexpr UInt32 kReloadCheckInterval = 3;
 
 std::optional<ReloadKey> GetReloadKey(Actor* actor)
 {
@@ -1213,10 +1452,10 @@ ReloadType OnReloadHandler::GetLastReloadForActor(Actor* actor)
 	if (!key)
 		return ReloadType::NonPartial;
 	std::shared_lock lock(g_reloadMapMutex);
-	const auto iter = g_reloadMap.find(*key);
-	if (iter == g_reloadMap.end())
+	const auto iter = g_reloadEvents.find(key->actorId);
+	if (iter == g_reloadEvents.end())
 		return ReloadType::NonPartial;
-	return iter->second.reloadType;
+	return iter->second.Newest()->reloadType;
 }
 
 void OnReloadHandler::SetDidReload(Actor* actor, ReloadType reloadType)
@@ -1227,58 +1466,67 @@ void OnReloadHandler::SetDidReload(Actor* actor, ReloadType reloadType)
 	auto* weapon = actor->GetWeaponForm();
 	if (!weapon)
 		return;
+	const UInt32 tick = g_reloadTick;
 	std::unique_lock lock(g_reloadMapMutex);
-	g_reloadMap.insert_or_assign(*key, ReloadHandler {
+	auto& ring = g_reloadEvents[key->actorId];
+	const auto* newest = ring.Newest();
+	// events pushed in the same tick share a check
+	const bool needsCheck = !newest || newest->tick != tick;
+	ring.Push(ReloadEvent {
+		.tick = tick,
 		.isLoopingReload = weapon->HasLoopingReloadAnim(),
 		.reloadType = reloadType
 	});
+	if (needsCheck)
+	{
+		g_reloadExpiryWheel.Schedule(tick + kReloadCheckInterval, { key->actorId, tick });
+		g_numReloadChecks = g_reloadExpiryWheel.Size();
+	}
+}
+
+static bool IsReloadOver(FormID actorId, const ReloadEvent& event)
+{
+	auto* actor = static_cast<Actor*>(LookupFormByRefID(actorId));
+	if (!actor || !DYNAMIC_CAST(actor, TESForm, Actor) || !actor->baseProcess)
+		return true;
+	const auto* animData = actor == g_thePlayer ? g_thePlayer->GetAnimData() : actor->baseProcess->GetAnimData();
+	if (!animData)
+		return true;
+	auto* weaponAnim = animData->animSequence[kSequence_Weapon];
+	if (!weaponAnim || !weaponAnim->animGroup)
+		return true;
+	const auto* ammoInfo = actor->baseProcess->GetAmmoInfo();
+	if (!ammoInfo)
+		return true;
+	// if the weapon anim is reload, it has already played
+	if (weaponAnim->animGroup->IsReload() && !event.isLoopingReload)
+		return true;
+	if (event.isLoopingReload && ammoInfo->count != 0 && !weaponAnim->animGroup->IsReload()) // reload finished
+		return true;
+	return false;
 }
 
 void OnReloadHandler::Update()
 {
+	const UInt32 tick = ++g_reloadTick;
+	if (!g_numReloadChecks)
+		return;
 	std::unique_lock lock(g_reloadMapMutex);
-	for (auto iter = g_reloadMap.begin(); iter != g_reloadMap.end();)
-	{
-		auto* actor = static_cast<Actor*>(LookupFormByRefID(iter->first.actorId));
-		if (!actor || !DYNAMIC_CAST(actor, TESForm, Actor) || !actor->baseProcess)
-		{
-			iter = g_reloadMap.erase(iter);
-			continue;
-		}
-		const auto* animData = actor == g_thePlayer ? g_thePlayer->GetAnimData() : actor->baseProcess->GetAnimData();
-		if (!animData)
-		{
-			iter = g_reloadMap.erase(iter);
-			continue;
-		}
-		auto* weaponAnim = animData->animSequence[kSequence_Weapon];
-		if (!weaponAnim || !weaponAnim->animGroup)
-		{
-			iter = g_reloadMap.erase(iter);
-			continue;
-		}
-		const auto* ammoInfo = actor->baseProcess->GetAmmoInfo();
-		if (!ammoInfo)
-		{
-			iter = g_reloadMap.erase(iter);
-			continue;
-		}
-		if (weaponAnim->animGroup->IsReload() && !iter->second.isLoopingReload)
-		{
-			// if the weapon anim is reload, it has already played
-			iter = g_reloadMap.erase(iter);
-			continue;
-		}
-		if (iter->second.isLoopingReload)
-		{
-			if (ammoInfo->count != 0 && !weaponAnim->animGroup->IsReload()) // reload finished
-			{
-				iter = g_reloadMap.erase(iter);
-				continue;
-			}
-		}
-		++iter;
-	}
+	g_reloadExpiryWheel.Advance(tick, [&](const std::pair<FormID, UInt32>& check)
+	{
+		const auto& [actorId, eventTick] = check;
+		const auto iter = g_reloadEvents.find(actorId);
+		if (iter == g_reloadEvents.end())
+			return;
+		const auto* newest = iter->second.Newest();
+		if (newest->tick != eventTick)
+			return;
+		if (IsReloadOver(actorId, *newest))
+			g_reloadEvents.erase(iter);
+		else
+			g_reloadExpiryWheel.Schedule(tick + kReloadCheckInterval, check);
+	});
+	g_numReloadChecks = g_reloadExpiryWheel.Size();
 }
 
 float GetTimePassed(AnimData* animData, UInt8 animGroupID)
@@ -1301,7 +1549,7 @@ void LogScript(Script* scriptObj, TESForm* form, const std::string& funcName)
 		LOG("\tGLOBALLY on any form");
 }
 
-ScopedList<char> GetDirectoryAnimPaths(std::string_view path)
+std::vector<std::string> GetDirectoryAnimPaths(std::string_view path)
 {
 	sv::stack_string<0x400> resultPath = path;
 	if (resultPath.ends_with('\\'))
@@ -1309,7 +1557,7 @@ ScopedList<char> GetDirectoryAnimPaths(std::string_view path)
 	
 	const sv::stack_string<0x400> searchPath = { R"(data\meshes\%s\*.kf)", resultPath.c_str() };
 	const sv::stack_string<0x400> renamePath = { R"(%s\*.kf)", resultPath.c_str() };
-	return FileFinder::FindFiles(searchPath.c_str(), renamePath.c_str(), ARCHIVE_TYPE_MESHES);
+	return FileFinder::FindFilesIndexed(searchPath.c_str(), renamePath.c_str(), ARCHIVE_TYPE_MESHES);
 }
 
 template <typename F>
@@ -1322,13 +1570,13 @@ bool OverrideAnimsFromScript(char* path, const F& overrideAnim)
 	// directory
 	const auto animPaths = GetDirectoryAnimPaths(pathStr.data());
 
-	if (animPaths.Empty())
+	if (animPaths.empty())
 		return false;
 
 	size_t numAnims = 0;
-	for (const auto* animPath : animPaths)
+	for (const auto& animPath : animPaths)
 	{
-		numAnims += overrideAnim(animPath);
+		numAnims += overrideAnim(animPath.c_str());
 	}
 	return numAnims != 0;
 }
@@ -1521,44 +1769,157 @@ bool Cmd_PlayAnimationPath_Execute(COMMAND_ARGS)
 	return true;
 }
 
-bool Cmd_kNVSEReset_Execute(COMMAND_ARGS)
+// returns whether the anim was playing
+static bool RemoveCustomAnimFromManager(AnimData* animData, BSAnimGroupSequence* anim, const char* path)
 {
-	bool refresh = false;
-	for (auto& [nameAndAnimData, context] : g_cachedAnimMap)
+	auto name = NiFixedString(path);
+
+	auto* manager = animData->controllerManager;
+	bool wasActive = false;
+	if (anim->m_eState != NiControllerSequence::INACTIVE)
 	{
-		auto name = NiFixedString(nameAndAnimData.first);
-		auto* animData = nameAndAnimData.second;
-		BSAnimGroupSequence* anim = context.anim;
+		wasActive = true;
+		if (anim->animGroup)
+			animData->ClearGroup(anim->animGroup->GetSequenceType(), 0.0);
+		manager->DeactivateSequence(anim, 0.0f);
+		NiUpdateData updateData{};
+		manager->Update(&updateData);
+	}
+	const auto seqCount = manager->sequences.EffectiveSize();
+	manager->sequences.Remove(anim);
+	const auto newSeqCount = manager->sequences.EffectiveSize();
+	DebugAssert(newSeqCount == seqCount - 1);
 
-		auto* manager = animData->controllerManager;
-		bool wasActive = false;
-		if (anim->m_eState != NiControllerSequence::INACTIVE)
+	const auto seqMapCount = manager->m_kSequenceMap.m_uiCount;
+	manager->m_kSequenceMap.RemoveAt(name);
+	DebugAssert(manager->m_kSequenceMap.m_uiCount == seqMapCount - 1);
+	return wasActive;
+}
+
+static bool IsCustomAnimEvictable(AnimData* animData, BSAnimGroupSequence* anim)
+{
+	if (anim->m_eState != NiControllerSequence::INACTIVE)
+		return false;
+	// hooks hold on to these until they are done with them
+	if (anim == g_lastLoopSequence || anim == g_fixHolsterUnequipAnim3rd)
+		return false;
+	return ra::find(animData->animSequence, anim) == std::end(animData->animSequence);
+}
+
+// state keyed by the address of a sequence that is being unloaded, a new sequence may get the same one
+static void EraseSequenceState(BSAnimGroupSequence* sequence)
+{
+	g_scriptCallExecutions.erase(sequence);
+	g_scriptLineExecutions.erase(sequence);
+	g_scriptSoundExecutions.erase(sequence);
+	Erase3rdPersonAnimGroupData(sequence);
+}
+
+// returns the unbound anim, only to be used as a key
+static BSAnimGroupSequence* EvictCustomAnim(AnimData* animData, AnimDataCustomAnims& customAnims, const char* path)
+{
+	std::unique_lock lock(customAnims.mutex);
+	const auto iter = customAnims.anims.find(path);
+	if (iter == customAnims.anims.end())
+		return nullptr;
+	BSAnimGroupSequence* anim = iter->second.context.anim;
+	// might have been played again since candidates were picked
+	if (!IsCustomAnimEvictable(animData, anim))
+		return nullptr;
+	RemoveCustomAnimFromManager(animData, anim, path);
+	g_kfModelCache.ReleaseBinding(path, iter->second.size);
+	customAnims.anims.erase(iter);
+	++g_kfModelCache.stats.evictedAnims;
+	return anim;
+}
+
+void EvictCustomAnims()
+{
+	// anims stay bound for a few seconds after their last lookup so that switching back and forth doesn't reload them
+	constexpr UInt32 kMinIdleFrames = 300;
+
+	g_kfModelCache.NextFrame();
+	if (!g_kfModelCache.IsOverBudget())
+		return;
+	// QueueNextAnim only keeps raw pointers, wait until the queued anims have played
+	if (g_queuedReplaceAnims.Size())
+		return;
+
+	struct Candidate
+	{
+		UInt32 lastUsedFrame;
+		AnimData* animData;
+		const char* path;
+		BSAnimGroupSequence* anim;
+	};
+	std::vector<Candidate> candidates;
+	const auto frame = g_kfModelCache.CurrentFrame();
+	g_animDataCustomAnims.ForEach([&](AnimData* animData, AnimDataCustomAnims& customAnims)
+	{
+		std::shared_lock lock(customAnims.mutex);
+		for (auto& [path, binding] : customAnims.anims)
 		{
-			wasActive = true;
-			if (anim->animGroup)
-				animData->ClearGroup(anim->animGroup->GetSequenceType(), 0.0);
-			manager->DeactivateSequence(anim, 0.0f);
-			NiUpdateData updateData{};
-			manager->Update(&updateData);
-		}
-		const auto seqCount = manager->sequences.EffectiveSize();
-		manager->sequences.Remove(anim);
-		const auto newSeqCount = manager->sequences.EffectiveSize();
-		DebugAssert(newSeqCount == seqCount - 1);
-
-		const auto seqMapCount = manager->m_kSequenceMap.m_uiCount;
-		manager->m_kSequenceMap.RemoveAt(name);
-		DebugAssert(manager->m_kSequenceMap.m_uiCount == seqMapCount - 1);
-		
-		auto* kfMap = ModelLoader::GetSingleton()->kfMap;
-		const auto kfCount = kfMap->GetCount();
-		kfMap->RemoveAt(name);
-		const auto newKfCount = kfMap->GetCount();
-		DebugAssert(newKfCount == kfCount - 1);
+			const UInt32 lastUsedFrame = binding.lastUsedFrame;
+			BSAnimGroupSequence* anim = binding.context.anim;
+			if (frame - lastUsedFrame >= kMinIdleFrames && IsCustomAnimEvictable(animData, anim))
+				candidates.push_back({ lastUsedFrame, animData, path, anim });
+		}
+	});
+	{
+		// time tracked anims are keyed by pointer and expected to stay loaded
+		std::unique_lock lock(g_animTimeMutex);
+		std::erase_if(candidates, [](const Candidate& candidate) { return g_timeTrackedAnims.contains(candidate.anim); });
+	}
+	ra::sort(candidates, {}, &Candidate::lastUsedFrame);
 
-		if (wasActive && animData->actor == g_thePlayer)
-			refresh = true;
+	std::vector<BSAnimGroupSequence*> evicted;
+	for (const auto& candidate : candidates)
+	{
+		if (!g_kfModelCache.IsOverBudget())
+			break;
+		if (const auto customAnims = g_animDataCustomAnims.Get(candidate.animData))
+		{
+			if (auto* anim = EvictCustomAnim(candidate.animData, *customAnims, candidate.path))
+				evicted.push_back(anim);
+		}
 	}
+
+	// g_animTimeMutex goes before the cache's lock, HandleExtraOperations loads models while holding it
+	std::unique_lock lock(g_animTimeMutex);
+	for (auto* anim : evicted)
+		EraseSequenceState(anim);
+
+	// bindings evicted above leave their models unbound; models of anims that are still tracked are kept since their
+	// script and sound keys point into the executions keyed by the model's sequence
+	std::unordered_set<std::string_view, CaseInsensitiveHash, CaseInsensitiveEqual> trackedPaths;
+	for (const auto& animTime : g_timeTrackedAnims | std::views::values)
+		trackedPaths.insert(animTime->anim->m_kName.CStr());
+	g_kfModelCache.EvictUnbound([&](const KFModel* model)
+	{
+		const auto* sequence = model->controllerSequence;
+		return !sequence || sequence != g_lastLoopSequence && !trackedPaths.contains(sequence->m_kName.CStr());
+	}, [](const KFModel* model)
+	{
+		if (model->controllerSequence)
+			EraseSequenceState(model->controllerSequence);
+	});
+}
+
+bool Cmd_kNVSEReset_Execute(COMMAND_ARGS)
+{
+	bool refresh = false;
+	FileFinder::InvalidateIndex();
+	g_animDataCustomAnims.ForEach([&](AnimData* animData, AnimDataCustomAnims& customAnims)
+	{
+		// binds into the same AnimData may run on AI task threads
+		std::unique_lock lock(customAnims.mutex);
+		for (auto& [path, binding] : customAnims.anims)
+		{
+			const bool wasActive = RemoveCustomAnimFromManager(animData, binding.context.anim, path);
+			if (wasActive && animData->actor == g_thePlayer)
+				refresh = true;
+		}
+	});
 	
 	g_animGroupFirstPersonMap.clear();
 	g_animGroupThirdPersonMap.clear();
@@ -1567,9 +1928,15 @@ bool Cmd_kNVSEReset_Execute(COMMAND_ARGS)
 	g_scriptSoundExecutions.clear();
 	g_scriptCallExecutions.clear();
 	g_scriptLineExecutions.clear();
-	g_cachedAnimMap.clear();
+	g_animDataCustomAnims.Clear();
+	// models are shared by every binding above, drop them from the engine once they are all unloaded
+	g_kfModelCache.Clear();
 	g_timeTrackedAnims.clear();
 	g_timeTrackedGroups.clear();
+	g_timeTrackedAnimOwners.Clear();
+	g_timeTrackedGroupOwners.Clear();
+	g_burstFireScheduler.Clear();
+	g_queuedReplaceAnims.Clear();
 	// HandleGarbageCollection();
 	LoadFileAnimPaths();
 
@@ -2690,8 +3057,7 @@ void CreateCommands(NVSECommandBuilder& builder)
 		auto* anim = FindOrLoadAnim(animData, animPath);
 		if (!anim || !anim->animGroup)
 			return true;
-		auto& queue = g_queuedReplaceAnims[std::make_pair(anim->animGroup->groupID, animData)];
-		queue.push_back(anim);
+		g_queuedReplaceAnims.Push(animData, anim->animGroup->groupID, anim);
 		*result = 1;
 		return true;
 	});
@@ -2718,11 +3084,7 @@ void CreateCommands(NVSECommandBuilder& builder)
 				return true;
 			animData = g_thePlayer->firstPersonAnimData;
 		}
-		if (const auto iter = g_queuedReplaceAnims.find(std::make_pair(anim->animGroup->groupID, animData)); iter != g_queuedReplaceAnims.end())
-		{
-			const auto& queue = iter->second;
-			*result = ra::find(queue, anim) != queue.end();
-		}
+		*result = g_queuedReplaceAnims.Contains(animData, anim->animGroup->groupID, anim);
 		return true;
 	});
 
@@ -3052,11 +3414,11 @@ void CreateCommands(NVSECommandBuilder& builder)
 		{
 			realPath = "data\\" + std::string(path.str());
 		}
-		const auto list = FileFinder::FindFiles(!realPath.empty() ? realPath.data() : path.data(), path.data(), archiveType);
+		const auto list = FileFinder::FindFilesIndexed(!realPath.empty() ? std::string_view(realPath) : path.str(), path.str(), archiveType);
 		NVSEArrayBuilder arr;
-		for (const auto* filePath : list)
+		for (const auto& filePath : list)
 		{
-			arr.Add(filePath);
+			arr.Add(filePath.c_str());
 		}
 		*result = reinterpret_cast<UInt32>(arr.Build(g_arrayVarInterface, scriptObj));
 		return true;
@@ -3290,6 +3652,70 @@ void CreateCommands(NVSECommandBuilder& builder)
 		return true;
 	}, nullptr, "LoadAnim");
 
+	builder.Create("GetkNVSEAnimCacheStats", kRetnType_Array, {}, false, [](COMMAND_ARGS)
+	{
+		const auto& stats = g_kfModelCache.stats;
+		NVSEStringMapBuilder map;
+		map.Add("hits", stats.hits.load());
+		map.Add("misses", stats.misses.load());
+		map.Add("evictedAnims", stats.evictedAnims.load());
+		map.Add("evictedModels", stats.evictedModels.load());
+		map.Add("models", g_kfModelCache.Size());
+		map.Add("bindings", g_kfModelCache.NumBindings());
+		map.Add("bytes", g_kfModelCache.TotalBytes());
+		map.Add("budget", g_kfModelCache.budgetBytes);
+		*result = reinterpret_cast<UInt32>(map.Build(g_arrayVarInterface, scriptObj));
+		return true;
+	});
+
+	// batch version of GetActiveAnims for scripts that query many actors, returns a map of ref ID to array of anims
+	builder.Create("GetActiveAnimsForRefs", kRetnType_Array, {
+		ParamInfo{"refs", kNVSEParamType_Array, false},
+		ParamInfo{"bIsFirstPerson", kNVSEParamType_Number, true}
+	}, false, [](COMMAND_ARGS)
+	{
+		*result = 0;
+		PluginExpressionEvaluator eval(PASS_COMMAND_ARGS);
+		if (!eval.ExtractArgs() || eval.NumArgs() < 1)
+			return true;
+		auto* refsArray = eval.GetNthArg(0)->GetArrayVar();
+		if (!refsArray)
+			return true;
+		int firstPerson = -1;
+		if (auto* firstPersonArg = eval.GetNthArg(1))
+			firstPerson = firstPersonArg->GetInt();
+
+		std::unordered_set<UInt32> seenRefs;
+		NVSEMapBuilder refsMap;
+		for (auto* form : NVSEArrayToVector<TESForm*>(g_arrayVarInterface, refsArray))
+		{
+			auto* actor = DYNAMIC_CAST(form, TESForm, Actor);
+			if (!actor || !seenRefs.insert(actor->refID).second)
+				continue;
+			auto* animData = GetAnimData(actor, firstPerson);
+			if (!animData || !animData->controllerManager)
+				continue;
+			NVSEArrayBuilder anims;
+			for (auto* sequence : animData->controllerManager->m_kActiveSequences)
+			{
+				if (!sequence || sequence->m_eState == NiControllerSequence::INACTIVE)
+					continue;
+				auto* anim = static_cast<BSAnimGroupSequence*>(sequence);
+				const bool hasGroup = IS_TYPE(anim, BSAnimGroupSequence) && anim->animGroup;
+				NVSEStringMapBuilder animMap;
+				animMap.Add("sequenceName", sequence->m_kName.CStr());
+				animMap.Add("animGroupId", hasGroup ? anim->animGroup->groupID : -1);
+				animMap.Add("calculatedTime", GetAnimTime(sequence));
+				animMap.Add("seqWeight", sequence->m_fSeqWeight);
+				animMap.Add("state", sequence->m_eState);
+				anims.Add(animMap.Build(g_arrayVarInterface, scriptObj));
+			}
+			refsMap.Add(actor->refID, anims.Build(g_arrayVarInterface, scriptObj));
+		}
+		*result = reinterpret_cast<UInt32>(refsMap.Build(g_arrayVarInterface, scriptObj));
+		return true;
+	});
+
 #undef PARAM
 #undef OPT_PARAM
 
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <bitset>
 #include <chrono>
 #include <filesystem>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <shared_mutex>
@@ -9,12 +13,15 @@
 #include <unordered_set>
 
 #include "CommandTable.h"
+#include "FrameCache.h"
 #include "GameForms.h"
 #include "GameObjects.h"
 #include "GameProcess.h"
 #include "game_types.h"
 #include "LambdaVariableContext.h"
+#include "owner_index.h"
 #include "ParamInfos.h"
+#include "queued_anim_store.h"
 #include "string_view_util.h"
 #include "utility.h"
 #include "bethesda/bethesda_types.h"
@@ -23,22 +30,70 @@ extern std::span<AnimGroupInfo> g_animGroupInfos;
 using FormID = UInt32;
 using GroupID = UInt16;
 
+// extra hit and eject key times of a burst fire KF (first of each is handled by the engine), hit times first
+struct BurstFireKeyTimes
+{
+	NiPointer<NiTextKeyExtraData> textKeys; // keeps the address from being reused while cached
+	const NiTextKey* keys = nullptr;
+	UInt32 numKeys = 0;
+	std::vector<float> times;
+	UInt32 numHitKeys = 0;
+
+	std::span<const float> HitTimes() const { return { times.data(), numHitKeys }; }
+	std::span<const float> EjectTimes() const { return { times.data() + numHitKeys, times.size() - numHitKeys }; }
+};
+
 struct BurstFireData
 {
-	bool firstPerson = false;
 	NiPointer<BSAnimGroupSequence> anim;
-	std::size_t index;
-	std::vector<NiTextKey*> hitKeys;
-	float timePassed;
-	bool shouldEject = false;
-	float lastNiTime = -FLT_MAX;
+	AnimData* animData = nullptr;
 	UInt32 actorId = 0;
-	std::vector<NiTextKey*> ejectKeys;
-	std::size_t ejectIdx = 0;
+	std::shared_ptr<const BurstFireKeyTimes> keyTimes;
+	UInt32 hitIdx = 0;
+	UInt32 ejectIdx = 0;
+	float lastNiTime = -FLT_MAX;
+	// anim time after which the next hit or eject key has to be processed
+	float nextDueTime = 0.0f;
 	bool reloading = false;
+
+	float GetNextDueTime() const;
+	bool IsDone() const;
+};
+
+class BurstFireScheduler
+{
+	std::vector<BurstFireData> bursts;
+	// only while bursts are in flight, an entry is dropped along with its last burst so that it doesn't keep the text keys
+	// of every burst fire KF loaded
+	std::unordered_map<NiTextKeyExtraData*, std::shared_ptr<const BurstFireKeyTimes>> keyTimesCache;
+	std::unordered_map<UInt32, UInt32> numBurstsByActor;
+
+	std::shared_ptr<const BurstFireKeyTimes> GetKeyTimes(BSAnimGroupSequence* anim);
+	void Remove(size_t index);
+public:
+	UInt32 peakActive = 0;
+
+	void Add(AnimData* animData, BSAnimGroupSequence* anim);
+	void Update();
+	void Clear();
+	size_t Size() const { return bursts.size(); }
+	// only scans when the actor has bursts in flight
+	void EraseOwnedBy(AnimData* animData, UInt32 actorId);
+
+	template <typename F>
+	void EraseIf(F&& f)
+	{
+		for (size_t i = 0; i < bursts.size();)
+		{
+			if (f(bursts[i]))
+				Remove(i);
+			else
+				++i;
+		}
+	}
 };
 
-extern std::list<BurstFireData> g_burstFireQueue;
+extern BurstFireScheduler g_burstFireScheduler;
 
 enum class POVSwitchState
 {
@@ -293,19 +348,39 @@ struct SavedAnimsTime
 	friend auto operator<=>(const SavedAnimsTime& lhs, const SavedAnimsTime& rhs) = default;
 };
 
+enum class FolderConditionType
+{
+	None, Male, Female, Mod1, Mod2, Mod3, Hurt, Human, Max=Human
+};
+
+// Everything derived from an AnimGroupOverride path, interned once per unique pooled path
+struct AnimPathInfo
+{
+	std::string_view path; // pooled
+	UInt64 hash = 0; // case-insensitive
+	std::string_view stem;
+	UInt64 stemHash = 0; // case-insensitive
+	FolderConditionType folderConditionType = FolderConditionType::None;
+	POVSwitchState pov = POVSwitchState::NotSet;
+	FullAnimGroupID groupId = 0xFFFF;
+
+	bool Equals(const AnimPathInfo& other) const
+	{
+		return this == &other || hash == other.hash && sv::equals_ci(path, other.path);
+	}
+};
+
+const AnimPathInfo& InternAnimPath(std::string_view path);
+
 struct AnimPath
 {
 	std::string_view path;
+	const AnimPathInfo* info = nullptr;
 	bool partialReload = false;
 	bool isStartAnim = false;
 	bool isAmmoSwap = false;
 };
 
-enum class FolderConditionType
-{
-	None, Male, Female, Mod1, Mod2, Mod3, Hurt, Human, Max=Human
-};
-
 enum AnimKeyTypes
 {
 	kAnimKeyType_ClampSequence = 0x0,
@@ -326,8 +401,11 @@ using GameAnimMap = NiTPointerMap<AnimSequenceBase*>;
 
 struct SavedAnims
 {
+	// variant sets are bitmasks over the indices of anims so that picking a variant doesn't allocate
+	static constexpr size_t kMaxVariants = 256;
+	using VariantMask = std::bitset<kMaxVariants>;
+
 	std::vector<std::unique_ptr<AnimPath>> anims; // inludes all random variants, or ordered variants, or in case reloads normal and partial reload animations
-	std::unordered_set<NiPointer<BSAnimGroupSequence>> linkedSequences;
 	bool hasOrder = false;
 	bool loaded = false;
 	std::function<bool(const Actor*)> folderCondition;
@@ -341,6 +419,10 @@ struct SavedAnims
 	bool hasAmmoSwap = false;
 	bool disabled = false;
 	std::string_view additiveAnimPath;
+	VariantMask allVariants;
+	VariantMask startVariants;
+	VariantMask partialReloadVariants;
+	VariantMask ammoSwapVariants;
 	
 	SavedAnims() = default;
 
@@ -356,6 +438,31 @@ struct SavedAnims
 		return folderCondition(actor);
 	}
 
+	VariantMask GetStemVariants(std::string_view fileStem) const
+	{
+		VariantMask result;
+		const auto stemHash = sv::hash_ci(fileStem);
+		const auto numVariants = min(anims.size(), kMaxVariants);
+		for (size_t i = 0; i < numVariants; ++i)
+		{
+			const auto& anim = anims[i];
+			if (anim->info->stemHash == stemHash && sv::equals_ci(anim->info->stem, fileStem))
+				result.set(i);
+		}
+		return result;
+	}
+
+	AnimPath* GetNthVariant(const VariantMask& variants, size_t n) const
+	{
+		const auto numVariants = min(anims.size(), kMaxVariants);
+		for (size_t i = 0; i < numVariants; ++i)
+		{
+			if (variants.test(i) && n-- == 0)
+				return anims[i].get();
+		}
+		return nullptr;
+	}
+
 	void Load()
 	{
 		if (!conditionScript && !conditionScriptText.empty())
@@ -363,7 +470,7 @@ struct SavedAnims
 
 		for (const auto& anim : anims)
 		{
-			const auto fileStem = sv::get_file_stem(anim->path);
+			const auto fileStem = anim->info->stem;
 			if (!hasOrder && sv::contains_ci(fileStem, "_order_"))
 				hasOrder = true;
 			if (!anim->partialReload && sv::contains_ci(fileStem, "_partial"))
@@ -384,6 +491,21 @@ struct SavedAnims
 		}
 		if (hasOrder)
 			std::ranges::sort(anims, [&](const auto& a, const auto& b) {return a->path < b->path; });
+
+		if (anims.size() > kMaxVariants)
+			ERROR_LOG(FormatString("%d variants found for %s, only the first %d will be picked", anims.size(), anims.front()->path.data(), kMaxVariants));
+		allVariants.reset();
+		startVariants.reset();
+		partialReloadVariants.reset();
+		ammoSwapVariants.reset();
+		for (size_t i = 0; i < min(anims.size(), kMaxVariants); ++i)
+		{
+			const auto& anim = *anims[i];
+			allVariants.set(i);
+			startVariants.set(i, anim.isStartAnim);
+			partialReloadVariants.set(i, anim.partialReload);
+			ammoSwapVariants.set(i, anim.isAmmoSwap);
+		}
 		loaded = true;
 	}
 };
@@ -431,12 +553,16 @@ struct JSONAnimContext
 
 using TimeTrackedAnimsMap = std::unordered_map<BSAnimGroupSequence*, std::unique_ptr<AnimTime>>;
 extern TimeTrackedAnimsMap g_timeTrackedAnims;
+// g_timeTrackedAnims keys by AnimTime::actorId
+extern OwnerIndex<UInt32, BSAnimGroupSequence*> g_timeTrackedAnimOwners;
 void EraseTimeTrackedAnim(BSAnimGroupSequence* anim);
 
 using TimeTrackedGroupsKey = std::pair<SavedAnims*, AnimData*>;
 using TimeTrackedGroupsPair = std::pair<const TimeTrackedGroupsKey, std::unique_ptr<SavedAnimsTime>>;
 using TimeTrackedGroupsMap = std::unordered_map<TimeTrackedGroupsKey, std::unique_ptr<SavedAnimsTime>, pair_hash, pair_equal>;
 extern TimeTrackedGroupsMap g_timeTrackedGroups;
+// g_timeTrackedGroups keys by AnimData
+extern OwnerIndex<AnimData*, TimeTrackedGroupsKey> g_timeTrackedGroupOwners;
 
 #define THISCALL(address, returnType, ...) reinterpret_cast<returnType(__thiscall*)(__VA_ARGS__)>(address)
 #define _CDECL(address, returnType, ...) reinterpret_cast<returnType(__cdecl*)(__VA_ARGS__)>(address)
@@ -513,7 +639,71 @@ struct BSAnimationContext
 	}
 };
 
+// A custom animation bound to one AnimData, the keyframe data it shares with other AnimDatas is in KFModelCache
+struct CustomAnimBinding
+{
+	BSAnimationContext context;
+	UInt32 size;
+	// written on lookups, which only hold the shared lock
+	std::atomic<UInt32> lastUsedFrame;
+
+	CustomAnimBinding(const BSAnimationContext& context, UInt32 size, UInt32 frame): context(context), size(size), lastUsedFrame(frame)
+	{
+	}
+};
+
+// Custom animations loaded into a single AnimData, guarded by their own lock so that unrelated actors never block each other
+struct AnimDataCustomAnims
+{
+	std::shared_mutex mutex;
+	// intentional const char*, anim paths are pooled and their pointers remain consistent throughout lifetime
+	std::unordered_map<const char*, CustomAnimBinding> anims;
+	// set under mutex once the AnimData is erased; a bind that got hold of this before that must not add to it
+	bool erased = false;
+};
+
+// Owns the AnimDataCustomAnims of every AnimData; sharded so that lookups for different AnimDatas rarely share a lock.
+// Entries are handed out as shared_ptr since they are used after the shard lock is released and may be erased by
+// another thread in the meantime.
+class AnimDataCustomAnimsMap
+{
+	static constexpr size_t kNumShards = 16;
+
+	struct Shard
+	{
+		std::shared_mutex mutex;
+		std::unordered_map<AnimData*, std::shared_ptr<AnimDataCustomAnims>> map;
+	};
+	std::array<Shard, kNumShards> shards;
+
+	Shard& GetShard(const AnimData* animData)
+	{
+		const auto ptr = reinterpret_cast<UInt32>(animData);
+		return shards[((ptr >> 4) ^ (ptr >> 12)) % kNumShards];
+	}
+public:
+	std::shared_ptr<AnimDataCustomAnims> Get(AnimData* animData);
+	std::shared_ptr<AnimDataCustomAnims> GetOrCreate(AnimData* animData);
+	void Erase(AnimData* animData);
+	void Clear();
+
+	template <typename F>
+	void ForEach(F&& f)
+	{
+		for (auto& shard : shards)
+		{
+			std::shared_lock lock(shard.mutex);
+			for (auto& [animData, customAnims] : shard.map)
+				f(animData, *customAnims);
+		}
+	}
+};
+
+extern AnimDataCustomAnimsMap g_animDataCustomAnims;
+
 std::optional<BSAnimationContext> LoadCustomAnimation(std::string_view path, AnimData* animData);
+// unloads least recently used custom anims that aren't playing while over the budget, called once per frame
+void EvictCustomAnims();
 std::optional<BSAnimationContext> LoadCustomAnimation(SavedAnims& animBundle, UInt16 groupId, AnimData* animData);
 BSAnimGroupSequence* LoadAnimationPath(const AnimationResult& result, AnimData* animData, UInt16 groupId);
 float GetDefaultBlendTime(const BSAnimGroupSequence* destSequence, const BSAnimGroupSequence* sourceSequence);
@@ -624,16 +814,41 @@ enum class ReloadType
 	NonPartial, Partial, AmmoSwap
 };
 
-struct ReloadHandler
+struct ReloadEvent
 {
+	UInt32 tick = 0;
 	bool isLoopingReload = false;
 	ReloadType reloadType = ReloadType::NonPartial;
 };
 
+// reload events of an actor's current reload, newest last; dropped as a whole once the reload is over
+struct ReloadEventRing
+{
+	static constexpr UInt32 kSize = 4;
+
+	std::array<ReloadEvent, kSize> events{};
+	UInt8 next = 0;
+	UInt8 count = 0;
+
+	void Push(const ReloadEvent& event)
+	{
+		events[next] = event;
+		next = (next + 1) % kSize;
+		if (count < kSize)
+			++count;
+	}
+
+	const ReloadEvent* Newest() const
+	{
+		return count ? &events[(next + kSize - 1) % kSize] : nullptr;
+	}
+};
+
 namespace OnReloadHandler
 {
 	ReloadType GetLastReloadForActor(Actor* actor);
 	void SetDidReload(Actor* actor, ReloadType reloadType = ReloadType::NonPartial);
+	// advances the reload clock, only actors whose expiry check is due this tick are looked at
 	void Update();
 }
 
@@ -655,15 +870,15 @@ NiControllerSequence::InterpArrayItem* FindAnimInterp(BSAnimGroupSequence* anim,
 extern thread_local bool g_isThreadCacheEnabled;
 
 template <typename Key, typename Value, typename Hash = pair_hash, typename Equal = pair_equal>
-using ResultCache = std::unordered_map<Key, Value, Hash, Equal>;
+using ResultCache = FrameCache<Key, Value, Hash, Equal>;
 
 using AnimationResultKey = std::pair<UInt32, AnimData*>;
 using AnimationResultValue = std::optional<AnimationResult>;
-using AnimationResultCache = ResultCache<const AnimationResultKey, AnimationResultValue>;
+using AnimationResultCache = ResultCache<AnimationResultKey, AnimationResultValue>;
 extern thread_local AnimationResultCache g_animationResultCache;
 
 using AnimPathKey = std::pair<SavedAnims*, AnimData*>;
-using AnimPathCache = ResultCache<const AnimPathKey, AnimPath*>;
+using AnimPathCache = ResultCache<AnimPathKey, AnimPath*>;
 
 extern thread_local AnimPathCache g_animPathFrameCache;
 
@@ -1,5 +1,8 @@
 ﻿#include "commands_misc.h"
 
+#include "commands_animation.h"
+#include "kf_model_cache.h"
+#include "main.h"
 #include "lib/clipboard/clipboardxx.hpp"
 
 void Commands::BuildMiscCommands(const NVSECommandBuilder& builder)
@@ -13,4 +16,23 @@ void Commands::BuildMiscCommands(const NVSECommandBuilder& builder)
         clipboard << text;
         return true;
     }, nullptr, "Copy");
+
+    builder.Create("PrintkNVSECounters", kRetnType_Default, {}, false, [](COMMAND_ARGS)
+    {
+        g_mapHitCounters.getActorAnimation.Print();
+        g_mapHitCounters.scriptCall.Print();
+        g_mapHitCounters.animPath.Print();
+        g_mapHitCounters.directoryIndex.Print();
+        g_lockContentionCounters.customAnimLookup.Print();
+        g_lockContentionCounters.customAnimBind.Print();
+        Console_Print("KF models %u bindings %u bytes %u budget %u", g_kfModelCache.Size(), g_kfModelCache.NumBindings(),
+            g_kfModelCache.TotalBytes(), g_kfModelCache.budgetBytes);
+        g_averageTimers.setOverrideAnimation.Print();
+        g_averageTimers.handleBurstFire.Print();
+        Console_Print("BurstFire active %u peak %u", static_cast<UInt32>(g_burstFireScheduler.Size()), g_burstFireScheduler.peakActive);
+        Console_Print("Log lines dropped %u", IDebugLog::GetDroppedCount());
+        g_mainThreadQueue.stats.Print();
+        g_workerPool.stats.Print();
+        return true;
+    });
 }
@@ -0,0 +1,106 @@
+#include "directory_index.h"
+
+#include <cctype>
+
+namespace
+{
+	bool EqualsCI(char a, char b)
+	{
+		return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+	}
+
+	std::string_view GetDirectory(std::string_view path)
+	{
+		const auto pos = path.find_last_of("\\/");
+		return pos == std::string_view::npos ? std::string_view() : path.substr(0, pos);
+	}
+
+	std::string_view GetFileName(std::string_view path)
+	{
+		const auto pos = path.find_last_of("\\/");
+		return pos == std::string_view::npos ? path : path.substr(pos + 1);
+	}
+
+	std::string MakeKey(std::string_view directory, UInt32 archiveType)
+	{
+		std::string key;
+		key.reserve(directory.size() + 12);
+		for (const char c : directory)
+			key += c == '/' ? '\\' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+		key += '|';
+		key += std::to_string(archiveType);
+		return key;
+	}
+}
+
+DirectoryIndex::DirectoryIndex(Lister lister) : lister(std::move(lister))
+{
+}
+
+DirectoryIndex::FileList DirectoryIndex::Find(std::string_view searchPath, std::string_view renamePath, UInt32 archiveType, bool* wasIndexed)
+{
+	const auto directory = GetDirectory(searchPath);
+	const auto pattern = GetFileName(searchPath);
+	const auto key = MakeKey(directory, archiveType);
+
+	std::unique_lock lock(mutex);
+	auto iter = directories.find(key);
+	if (wasIndexed)
+		*wasIndexed = iter != directories.end();
+	if (iter == directories.end())
+		iter = directories.emplace(key, lister(directory, archiveType)).first;
+
+	std::string prefix(GetDirectory(renamePath));
+	if (!prefix.empty())
+		prefix += '\\';
+
+	FileList result;
+	for (const auto& name : iter->second)
+	{
+		if (WildcardMatch(pattern, name))
+			result.push_back(prefix + name);
+	}
+	return result;
+}
+
+void DirectoryIndex::Invalidate()
+{
+	std::unique_lock lock(mutex);
+	directories.clear();
+}
+
+size_t DirectoryIndex::NumDirectories()
+{
+	std::unique_lock lock(mutex);
+	return directories.size();
+}
+
+bool DirectoryIndex::WildcardMatch(std::string_view pattern, std::string_view name)
+{
+	// greedy match, backtracking to the last * on mismatch
+	size_t p = 0, n = 0;
+	size_t starPos = std::string_view::npos, starMatch = 0;
+	while (n < name.size())
+	{
+		if (p < pattern.size() && (pattern[p] == '?' || EqualsCI(pattern[p], name[n])))
+		{
+			++p;
+			++n;
+		}
+		else if (p < pattern.size() && pattern[p] == '*')
+		{
+			starPos = p++;
+			starMatch = n;
+		}
+		else if (starPos != std::string_view::npos)
+		{
+			p = starPos + 1;
+			n = ++starMatch;
+		}
+		else
+			return false;
+	}
+	while (p < pattern.size() && pattern[p] == '*')
+		++p;
+	return p == pattern.size();
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Case-insensitive index of the files directly inside each searched directory, loose and archived alike, so that
+// repeated wildcard searches of a folder are answered from memory instead of walking the data folder and every
+// archive again. A directory is listed through the callback the first time it is searched and kept until Invalidate().
+// Nothing in here touches the game, the callback decides where the file names come from.
+class DirectoryIndex
+{
+public:
+	using FileList = std::vector<std::string>;
+	// names of all files directly inside directory, without the directory
+	using Lister = std::function<FileList(std::string_view directory, UInt32 archiveType)>;
+
+	explicit DirectoryIndex(Lister lister);
+
+	// searchPath is a directory followed by a file name pattern, e.g. data\meshes\foo\*.kf
+	// matches are prefixed with the directory of renamePath, same as the engine's file finder
+	FileList Find(std::string_view searchPath, std::string_view renamePath, UInt32 archiveType, bool* wasIndexed = nullptr);
+
+	void Invalidate();
+	size_t NumDirectories();
+
+	// case-insensitive, supports * and ?
+	static bool WildcardMatch(std::string_view pattern, std::string_view name);
+
+private:
+	Lister lister;
+	std::mutex mutex;
+	std::unordered_map<std::string, FileList> directories;
+};
@@ -5,6 +5,7 @@
 #include "utility.h"
 #include "commands_animation.h"
 #include "file_animations.h"
+#include "task_queue.h"
 #include "lib/json/json.h"
 #include <fstream>
 #include <ranges>
@@ -157,9 +158,45 @@ struct ScopedTimer
 	const char* name;
 };
 
-void HandleJson(const fs::path& path, std::vector<JSONEntry>& jsonEntries)
+struct ParsedJson
+{
+	nlohmann::json json;
+	std::string error;
+	bool empty = false;
+};
+
+// only reads and parses, runs on the worker pool
+ParsedJson ParseJsonFile(const fs::path& path)
+{
+	ParsedJson result;
+	std::ifstream i(path);
+	if (i.peek() == std::ifstream::traits_type::eof())
+	{
+		result.empty = true;
+		return result;
+	}
+	try
+	{
+		i >> result.json;
+	}
+	catch (nlohmann::json::exception& e)
+	{
+		result.error = e.what();
+	}
+	return result;
+}
+
+void HandleJson(const fs::path& path, ParsedJson parsed, std::vector<JSONEntry>& jsonEntries)
 {
 	LOG("\nReading from JSON file " + path.string());
+	if (parsed.empty)
+		return;
+	if (!parsed.error.empty())
+	{
+		ERROR_LOG("The JSON is incorrectly formatted! It will not be applied. Path: " + path.string());
+		ERROR_LOG(FormatString("JSON error: %s\n", parsed.error.c_str()));
+		return;
+	}
 	const auto strToFormID = [](const std::string& formIdStr)
 	{
 		const auto formId = HexStringToInt(formIdStr);
@@ -171,11 +208,7 @@ void HandleJson(const fs::path& path, std::vector<JSONEntry>& jsonEntries)
 	};
 	try
 	{
-		std::ifstream i(path);
-		if (i.peek() == std::ifstream::traits_type::eof())
-			return;
-		nlohmann::json j;
-		i >> j;
+		auto& j = parsed.json;
 		if (j.is_array())
 		{
 			for (auto& elem : j)
@@ -211,7 +244,7 @@ void HandleJson(const fs::path& path, std::vector<JSONEntry>& jsonEntries)
 				auto pollCondition = false;
 				if (elem.contains("condition"))
 				{
-					condition = AddStringToPool(elem["condition"].get<std::string_view>());
+					condition = InternConditionScriptText(elem["condition"].get<std::string_view>());
 					if (elem.contains("pollCondition"))
 						pollCondition = elem["pollCondition"].get<bool>();
 				}
@@ -423,6 +456,8 @@ void LoadFileAnimPaths()
 	const fs::path dir = R"(Data\Meshes\AnimGroupOverride)";
 	std::vector<std::string_view> bsaAnimPaths;
 	std::vector<JSONEntry> jsonEntries;
+	// JSON files are read and parsed on the worker pool while the folders are scanned, then applied in order
+	std::vector<std::pair<fs::path, std::future<ParsedJson>>> jsonFiles;
 	if (exists(dir))
 	{
 		for (const auto& iter : fs::directory_iterator(dir))
@@ -441,7 +476,7 @@ void LoadFileAnimPaths()
 				}
 			}
 			else if (sv::equals_ci(ext, ".json"))
-				HandleJson(path, jsonEntries);
+				jsonFiles.emplace_back(path, g_workerPool.Submit([path] { return ParseJsonFile(path); }));
 			else if (sv::equals_ci(ext, ".bsa"))
 				LoadAnimPathsFromBSA(path, bsaAnimPaths);
 		}
@@ -450,7 +485,10 @@ void LoadFileAnimPaths()
 	{
 		LOG(dir.string() + " does not exist.");
 	}
+	for (auto& [path, parsed] : jsonFiles)
+		HandleJson(path, parsed.get(), jsonEntries);
 	LoadJsonEntries(jsonEntries, bsaAnimPaths);
+	LogConditionScriptStats();
 }
 
 
@@ -1,6 +1,7 @@
 #include "game_types.h"
 
 #include "commands_animation.h"
+#include "directory_index.h"
 #include "GameData.h"
 #include "GameOSDepend.h"
 #include "GameProcess.h"
@@ -8,6 +9,8 @@
 #include <span>
 
 #include "hooks.h"
+#include "main.h"
+#include "string_view_util.h"
 
 bool AnimSequenceBase::Contains(BSAnimGroupSequence* anim)
 {
@@ -217,6 +220,43 @@ ScopedList<char> FileFinder::FindFiles(const char* path, const char* renameDirec
 	return std::move(*result);
 }
 
+namespace
+{
+	DirectoryIndex g_directoryIndex([](std::string_view directory, UInt32 archiveType)
+	{
+		const auto searchPath = std::string(directory) + "\\*";
+		DirectoryIndex::FileList names;
+		for (const char* path : FileFinder::FindFiles(searchPath.c_str(), searchPath.c_str(), static_cast<ARCHIVE_TYPE>(archiveType)))
+		{
+			if (path)
+				names.emplace_back(sv::get_file_name(path));
+		}
+		return names;
+	});
+}
+
+std::vector<std::string> FileFinder::FindFilesIndexed(std::string_view path, std::string_view renameDirectory, ARCHIVE_TYPE archiveType)
+{
+	const auto dirEnd = path.find_last_of('\\');
+	if (dirEnd != std::string_view::npos && path.substr(0, dirEnd).find_first_of("*?") != std::string_view::npos)
+	{
+		// wildcards in the folder part can't be answered from a single folder listing
+		std::vector<std::string> result;
+		for (const char* file : FindFiles(std::string(path).c_str(), std::string(renameDirectory).c_str(), archiveType))
+			result.emplace_back(file);
+		return result;
+	}
+	bool wasIndexed;
+	auto result = g_directoryIndex.Find(path, renameDirectory, archiveType, &wasIndexed);
+	g_mapHitCounters.directoryIndex.Record(wasIndexed);
+	return result;
+}
+
+void FileFinder::InvalidateIndex()
+{
+	g_directoryIndex.Invalidate();
+}
+
 AnimGroupInfo* GetGroupInfo(AnimGroupID groupId)
 {
 	return &g_animGroupInfos[groupId];
@@ -1063,6 +1063,10 @@ public:
 namespace FileFinder
 {
 	ScopedList<char> FindFiles(const char* path, const char* renameDirectory, ARCHIVE_TYPE archiveType);
+
+	// same results as FindFiles, but each folder is only enumerated once and then matched from the directory index
+	std::vector<std::string> FindFilesIndexed(std::string_view path, std::string_view renameDirectory, ARCHIVE_TYPE archiveType);
+	void InvalidateIndex();
 }
 
 class BSWin32Audio
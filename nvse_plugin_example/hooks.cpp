@@ -18,6 +18,7 @@
 #include "blend_fixes.h"
 #include "blend_smoothing.h"
 #include "jip_fixes.h"
+#include "kf_model_cache.h"
 #include "knvse_events.h"
 #include "movement_blend_fixes.h"
 #include "sequence_extradata.h"
@@ -26,24 +27,12 @@ bool g_startedAnimation = false;
 BSAnimGroupSequence* g_lastLoopSequence = nullptr;
 extern bool g_fixHolster;
 
-std::map<std::pair<FullAnimGroupID, AnimData*>, std::deque<BSAnimGroupSequence*>> g_queuedReplaceAnims;
+QueuedAnimStore g_queuedReplaceAnims;
 
 
 BSAnimGroupSequence* GetQueuedAnim(AnimData* animData, FullAnimGroupID animGroupId)
 {
-	const auto key = std::make_pair(animGroupId, animData);
-	const auto it = g_queuedReplaceAnims.find(key);
-	if (it != g_queuedReplaceAnims.end())
-	{
-		auto& queue = it->second;
-		if (!queue.empty())
-		{
-			auto* anim = queue.front();
-			queue.pop_front();
-			return anim;
-		}
-	}
-	return nullptr;
+	return g_queuedReplaceAnims.Pop(animData, animGroupId);
 }
 
 void Apply3rdPersonRespectEndKeyEaseInFix(AnimData* animData, BSAnimGroupSequence* anim3rd);
@@ -628,8 +617,6 @@ thread_local PluginGlobalData g_globals;
 
 thread_local bool g_isThreadCacheEnabled = false;
 
-SynchronizedQueue g_mainThreadQueue;
-
 
 #if _DEBUG
 static HHOOK hHook = nullptr;
@@ -735,6 +722,9 @@ void ApplyHooks()
 	const std::string legacyAnimTimePaths = ini.GetOrCreate("Anim Fixes", "sLegacyAnimTimePaths", "B42Inject,B42Interact,B42Loot", "; use legacy anim time algorithm for these paths (these mods rely on bugged behavior from previous versions of kNVSE).");
 	if (!legacyAnimTimePaths.empty())
 		conf.legacyAnimTimePaths = SplitString(legacyAnimTimePaths);
+
+	const auto customAnimBudgetMB = ini.GetOrCreate("General", "iCustomAnimMemoryBudgetMB", 0, "; approximate memory in MB that custom animations may use before kNVSE unloads the least recently used ones that aren't playing, 0 = no limit");
+	g_kfModelCache.budgetBytes = customAnimBudgetMB > 0 ? static_cast<UInt32>(customAnimBudgetMB) * 1024 * 1024 : 0;
 		
 	//WriteRelJump(0x4949D0, AnimationHook);
 	
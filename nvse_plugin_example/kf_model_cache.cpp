@@ -0,0 +1,164 @@
+#include "kf_model_cache.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include "GameTasks.h"
+#include "NiNodes.h"
+
+KFModelCache g_kfModelCache;
+
+namespace
+{
+	// KFs are mostly exported at 30 fps with a rotation and a translation key per controlled block and frame
+	constexpr float kKeysPerSecond = 30.0f;
+	constexpr UInt32 kKeyBytesPerBlock = 28;
+}
+
+KFModelCache::EntryMap::iterator KFModelCache::Find(const char* path)
+{
+	if (const auto iter = entries.find(path); iter != entries.end())
+		return iter;
+	if (const auto alias = aliases.find(path); alias != aliases.end())
+		return entries.find(alias->second);
+	return entries.end();
+}
+
+KFModel* KFModelCache::Get(const char* path)
+{
+	{
+		std::shared_lock lock(mutex);
+		if (const auto iter = Find(path); iter != entries.end())
+			return iter->second.model;
+	}
+	// loaded outside the lock, two threads racing for the same path get the same model from the engine's KF map
+	auto* kfMap = ModelLoader::GetSingleton()->kfMap;
+	KFModel* engineModel = nullptr;
+	const bool ownedByCache = !kfMap->Get(path, &engineModel);
+	auto* model = ModelLoader::LoadKFModel(path);
+	if (!model)
+		return nullptr;
+	std::unique_lock lock(mutex);
+	if (const auto iter = Find(path); iter != entries.end())
+		return iter->second.model;
+	// the KF map doesn't care about case, the pooled strings do; count a model once no matter how it was asked for
+	if (const auto otherPath = pathsByModel.find(model); otherPath != pathsByModel.end())
+	{
+		aliases.emplace(path, otherPath->second);
+		return model;
+	}
+	pathsByModel.emplace(model, path);
+	auto& entry = entries.emplace(path, Entry{ model }).first->second;
+	entry.lastUsedFrame = frame;
+	entry.ownedByCache = ownedByCache;
+	if (ownedByCache)
+	{
+		entry.size = EstimateModelSize(model->controllerSequence);
+		totalBytes += entry.size;
+	}
+	return model;
+}
+
+void KFModelCache::AddBinding(const char* path, UInt32 bindingSize)
+{
+	std::unique_lock lock(mutex);
+	if (const auto iter = Find(path); iter != entries.end())
+	{
+		++iter->second.numBindings;
+		iter->second.lastUsedFrame = frame;
+		totalBytes += bindingSize;
+	}
+}
+
+void KFModelCache::ReleaseBinding(const char* path, UInt32 bindingSize)
+{
+	std::unique_lock lock(mutex);
+	if (const auto iter = Find(path); iter != entries.end() && iter->second.numBindings)
+	{
+		--iter->second.numBindings;
+		iter->second.lastUsedFrame = frame;
+		totalBytes -= bindingSize;
+	}
+}
+
+UInt32 KFModelCache::EvictUnbound(const std::function<bool(const KFModel*)>& canEvict, const std::function<void(const KFModel*)>& onEvict)
+{
+	std::unique_lock lock(mutex);
+	std::vector<std::pair<UInt32, const char*>> unbound;
+	for (const auto& [path, entry] : entries)
+	{
+		if (!entry.numBindings && entry.ownedByCache)
+			unbound.emplace_back(entry.lastUsedFrame, path);
+	}
+	std::ranges::sort(unbound);
+
+	auto* kfMap = ModelLoader::GetSingleton()->kfMap;
+	UInt32 numEvicted = 0;
+	for (const auto& [lastUsedFrame, path] : unbound)
+	{
+		if (!IsOverBudget())
+			break;
+		const auto iter = entries.find(path);
+		if (!canEvict(iter->second.model))
+			continue;
+		onEvict(iter->second.model);
+		totalBytes -= iter->second.size;
+		kfMap->RemoveAt(NiFixedString(path));
+		std::erase_if(aliases, [&](const auto& alias) { return alias.second == path; });
+		pathsByModel.erase(iter->second.model);
+		entries.erase(iter);
+		++numEvicted;
+	}
+	stats.evictedModels += numEvicted;
+	return numEvicted;
+}
+
+void KFModelCache::Clear()
+{
+	std::unique_lock lock(mutex);
+	auto* kfMap = ModelLoader::GetSingleton()->kfMap;
+	for (const auto& [path, entry] : entries)
+	{
+		if (entry.ownedByCache)
+			kfMap->RemoveAt(NiFixedString(path));
+	}
+	entries.clear();
+	aliases.clear();
+	pathsByModel.clear();
+	totalBytes = 0;
+}
+
+UInt32 KFModelCache::Size() const
+{
+	std::shared_lock lock(mutex);
+	return entries.size();
+}
+
+UInt32 KFModelCache::NumBindings() const
+{
+	std::shared_lock lock(mutex);
+	UInt32 count = 0;
+	for (const auto& [path, entry] : entries)
+		count += entry.numBindings;
+	return count;
+}
+
+UInt32 KFModelCache::EstimateModelSize(const NiControllerSequence* sequence)
+{
+	if (!sequence)
+		return 0;
+	const auto duration = max(sequence->m_fEndKeyTime - sequence->m_fBeginKeyTime, 0.0f);
+	const auto numKeys = static_cast<UInt32>(duration * kKeysPerSecond) + 1;
+	UInt32 size = sequence->m_uiArraySize * numKeys * kKeyBytesPerBlock;
+	if (const NiTextKeyExtraData* textKeys = sequence->m_spTextKeys)
+		size += textKeys->GetKeys().size() * sizeof(NiTextKey);
+	return size + EstimateBindingSize(sequence);
+}
+
+UInt32 KFModelCache::EstimateBindingSize(const NiControllerSequence* sequence)
+{
+	if (!sequence)
+		return 0;
+	return sizeof(NiControllerSequence) + sequence->m_uiArraySize * (sizeof(NiControllerSequence::InterpArrayItem) + sizeof(NiControllerSequence::IDTag));
+}
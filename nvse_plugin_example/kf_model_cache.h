@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <shared_mutex>
+#include <unordered_map>
+
+class KFModel;
+class NiControllerSequence;
+
+// Shared level of custom animations: one entry per KF path no matter how many AnimDatas the anim gets bound to.
+// The engine's KFModel holds the parsed keyframe data, each AnimData only keeps a binding (see AnimDataCustomAnims)
+// with the sequence set up for its controller manager. Entries count their bindings so that a model nothing is
+// bound to can be told apart from one in use.
+// Both levels are accounted by approximate size against the budget from the INI; once it is exceeded, inactive
+// bindings and then unbound models are evicted least recently used first (see EvictCustomAnims).
+class KFModelCache
+{
+	struct Entry
+	{
+		KFModel* model = nullptr;
+		UInt32 numBindings = 0;
+		UInt32 size = 0;
+		UInt32 lastUsedFrame = 0;
+		// false if the engine had already loaded the model, it is then neither accounted nor ever removed by the cache
+		bool ownedByCache = true;
+	};
+
+	using EntryMap = std::unordered_map<const char*, Entry>;
+
+	mutable std::shared_mutex mutex;
+	// intentional const char*, anim paths are pooled and their pointers remain consistent throughout lifetime
+	EntryMap entries;
+	// other pooled spellings (case) of a path in entries that the engine resolved to the same model
+	std::unordered_map<const char*, const char*> aliases;
+	// path in entries of each model, finds the entry a new spelling is an alias of
+	std::unordered_map<const KFModel*, const char*> pathsByModel;
+	// approximate bytes of every cached model and binding
+	std::atomic<UInt32> totalBytes = 0;
+	std::atomic<UInt32> frame = 0;
+
+	// path directly or through its alias, must hold mutex
+	EntryMap::iterator Find(const char* path);
+
+public:
+	// cumulative, read by scripts through GetkNVSEAnimCacheStats
+	struct Stats
+	{
+		std::atomic<UInt32> hits = 0;
+		std::atomic<UInt32> misses = 0;
+		std::atomic<UInt32> evictedAnims = 0;
+		std::atomic<UInt32> evictedModels = 0;
+	};
+	Stats stats;
+
+	// 0 means no limit
+	UInt32 budgetBytes = 0;
+
+	// loads the model through the engine the first time path is requested, nullptr if it failed to load
+	KFModel* Get(const char* path);
+
+	// path is resolved the same way as in Get
+	void AddBinding(const char* path, UInt32 bindingSize);
+	void ReleaseBinding(const char* path, UInt32 bindingSize);
+
+	// drops the least recently used owned models nothing is bound to and canEvict agrees on, from here and from the
+	// engine's KF map, until the total is back within budget; onEvict is called for each right before it is dropped.
+	// Both are called with the cache locked. Returns how many were dropped
+	UInt32 EvictUnbound(const std::function<bool(const KFModel*)>& canEvict, const std::function<void(const KFModel*)>& onEvict);
+
+	// forgets every model and removes those it owns from the engine's KF map, bindings must have been unloaded first
+	void Clear();
+
+	UInt32 Size() const;
+	UInt32 NumBindings() const;
+	UInt32 TotalBytes() const { return totalBytes; }
+	bool IsOverBudget() const { return budgetBytes && totalBytes > budgetBytes; }
+
+	UInt32 CurrentFrame() const { return frame; }
+	void NextFrame() { ++frame; }
+
+	// keyframe data shared through the model, including the model's own sequence
+	static UInt32 EstimateModelSize(const NiControllerSequence* sequence);
+	// sequence set up for a single controller manager
+	static UInt32 EstimateBindingSize(const NiControllerSequence* sequence);
+};
+
+extern KFModelCache g_kfModelCache;
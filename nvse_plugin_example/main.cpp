@@ -42,8 +42,6 @@ NVSEInterface* g_nvseInterface;
 NVSECommandTableInterface* g_cmdTable;
 const CommandInfo* g_TFC;
 PlayerCharacter* g_player;
-ICriticalSection g_executionQueueCS;
-std::deque<std::function<void()>> g_synchronizedExecutionQueue;
 ExpressionEvaluatorUtils s_expEvalUtils;
 
 std::unordered_map<std::string, std::vector<CustomAnimGroupScript>> g_customAnimGroups;
@@ -59,6 +57,7 @@ _CaptureLambdaVars CaptureLambdaVars;
 _UncaptureLambdaVars UncaptureLambdaVars;
 std::vector<std::string> g_eachFrameScriptLines;
 MapHitCounters g_mapHitCounters;
+LockContentionCounters g_lockContentionCounters;
 AverageTimers g_averageTimers;
 std::recursive_mutex g_pollConditionMutex;
 
@@ -93,17 +92,16 @@ bool CallFunction(Script* funcScript, TESObjectREFR* callingObj, TESObjectREFR*
 	NVSEArrayVarInterface::Element* result)
 {
 	const auto cacheKey = std::make_pair(callingObj, funcScript);
-	ScriptCacheValue* cachePtr = nullptr;
 	const auto useCache = g_isThreadCacheEnabled;
 	if (useCache)
 	{
-		const auto [mapIter, isNew] = g_scriptCache.emplace(cacheKey, NVSEArrayVarInterface::Element{});
+		const auto [cached, isNew] = g_scriptCache.Emplace(cacheKey);
+		g_mapHitCounters.scriptCall.Record(!isNew);
 		if (!isNew)
 		{
-			*result = mapIter->second;
+			*result = *cached;
 			return true;
 		}
-		cachePtr = &mapIter->second;
 	}
 	g_globals.isInConditionFunction = true;
 	const auto success = g_script->CallFunction(
@@ -115,7 +113,7 @@ bool CallFunction(Script* funcScript, TESObjectREFR* callingObj, TESObjectREFR*
 	);
 	g_globals.isInConditionFunction = false;
 	if (useCache)
-		*cachePtr = *result;
+		g_scriptCache.Set(cacheKey, *result);
 	return success;
 }
 
@@ -142,6 +140,11 @@ void Save3rdPersonAnimGroupData(BSAnimGroupSequence* anim3rd)
 	g_thirdPersonSavedData.try_emplace(anim3rd, thirdPersonSavedData);
 }
 
+void Erase3rdPersonAnimGroupData(BSAnimGroupSequence* anim3rd)
+{
+	g_thirdPersonSavedData.erase(anim3rd);
+}
+
 void Set3rdPersonAnimTimes(BSAnimGroupSequence* anim3rd, BSAnimGroupSequence* anim1st)
 {
 	TESAnimGroup* animGroup3rd = anim3rd->animGroup;
@@ -183,7 +186,12 @@ bool IsSequenceInAnimBundle(AnimData* animData, UInt16 nearestGroupId, const std
 			return false;
 		return animBase->Contains(anim);
 	}
-	return animResult->animBundle->linkedSequences.contains(anim);
+	// by name rather than by pointer, bundles don't hold on to the sequences bound from them so that evicting a binding
+	// or deleting its AnimData frees it
+	return std::ranges::any_of(animResult->animBundle->anims, [&](const auto& animPath)
+	{
+		return sv::equals_ci(animPath->path, anim->m_kName.CStr());
+	});
 }
 
 bool IsAnimBundleEqual(const std::optional<AnimationResult>& animResult, const SavedAnims& savedAnims)
@@ -244,6 +252,7 @@ void HandlePollConditionAnims()
 	{
 		const auto erase = [&]
 		{
+			g_timeTrackedGroupOwners.Remove(key.second, key);
 			g_timeTrackedGroups.erase(key);
 		};
 		auto animTime = *animTimePtr;
@@ -351,6 +360,7 @@ void HandleCustomTextKeys()
 					g_script->CallFunctionAlt(cleanUpScript, actor, 2, path.c_str(), animTime.firstPerson);
 				}
 			}
+			g_timeTrackedAnimOwners.Remove(animTime.actorId, it->first);
 			it = g_timeTrackedAnims.erase(it);
 		};
 
@@ -559,106 +569,8 @@ bool IsGodMode()
 
 void HandleBurstFire()
 {
-	auto iter = g_burstFireQueue.begin();
-	while (iter != g_burstFireQueue.end())
-	{
-		auto& [firstPerson, anim, index, hitKeys, _, shouldEject, lastNiTime, actorId, ejectKeys, ejectIdx, reloading] = *iter;
-		const auto erase = [&]()
-		{
-			iter = g_burstFireQueue.erase(iter);
-		};
-		auto* actor = DYNAMIC_CAST(LookupFormByRefID(actorId), TESForm, Actor);
-		if (!actor || actor->IsDeleted() || actor->IsDead(true) || !anim || !anim->animGroup || anim->m_fLastScaledTime - lastNiTime < -0.01f && anim->m_eCycleType != NiControllerSequence::LOOP)
-		{
-			erase();
-			continue;
-		}
-		auto* animData = firstPerson ? g_thePlayer->firstPersonAnimData : actor->baseProcess->GetAnimData();
-		if (!animData)
-		{
-			erase();
-			continue;
-		}
-		lastNiTime = anim->m_fLastScaledTime;
-		auto* currentAnim = animData->animSequence[kSequence_Weapon];
-		auto* weapon = actor->GetWeaponForm();
-		if (currentAnim != anim)
-		{
-			erase();
-			continue;
-		}
-		//timePassed += GetTimePassed(animData, anim->animGroup->groupID);
-		const auto timePassed = anim->m_fLastScaledTime;
-		if (timePassed <= anim->animGroup->keyTimes[kSeqState_HitOrDetach])
-		{
-			// first hit handled by engine
-			// don't want duplicated shootings
-			++iter;
-			continue;
-		}
-		const auto passedHitKey = index < hitKeys.size() && timePassed > hitKeys.at(index)->m_fTime;
-		const auto passedEjectKey = ejectIdx < ejectKeys.size() && !ejectKeys.empty() && ejectIdx < ejectKeys.size() && timePassed > ejectKeys.at(ejectIdx)->m_fTime;
-		if (passedHitKey || passedEjectKey)
-		{
-			if (auto* ammoInfo = actor->baseProcess->GetAmmoInfo()) // static_cast<Decoding::MiddleHighProcess*>(animData->actor->baseProcess)->ammoInfo
-			{
-				if (!IsGodMode())
-				{
-					//const auto clipSize = GetWeaponInfoClipSize(actor);
-					if (ammoInfo->count == 0 || actor->IsAnimActionReload())
-					{
-						// reloaded
-						reloading = true;
-					}
-#if 0
-					const auto ammoCount = ammoInfo->countDelta;
-					if (weapon && (ammoCount == 0 || ammoCount == clipSize))
-					{
-						erase();
-						continue;
-					}
-#endif
-				}
-			}
-			if (passedHitKey)
-				++index;
-			if (!IsPlayersOtherAnimData(animData))
-			{
-				bool ejected = false;
-				if (passedHitKey)
-				{
-					if (!reloading)
-						actor->FireWeapon();
-					if (!passedEjectKey && ejectKeys.empty() || ejectIdx == ejectKeys.size())
-					{
-						if (!reloading)
-							actor->EjectFromWeapon(weapon);
-						ejected = true;
-					}
-				}
-				if (!ejected && passedEjectKey)
-				{
-					actor->EjectFromWeapon(weapon);
-					++ejectIdx;
-				}
-			}
-		}
-		
-		if (index < hitKeys.size() || !ejectKeys.empty() && ejectIdx < ejectKeys.size())
-			++iter;
-		else
-			erase();
-	}
-}
-
-void HandleSynchronizedExecutionQueue()
-{
-	ScopedLock lock(g_executionQueueCS);
-	while (!g_synchronizedExecutionQueue.empty())
-	{
-		g_synchronizedExecutionQueue.front()();
-		g_synchronizedExecutionQueue.pop_front();
-	}
+	FunctionTimer timer(&g_averageTimers.handleBurstFire);
+	g_burstFireScheduler.Update();
 }
 
 void ApplyHolsterFix()
@@ -682,27 +594,9 @@ void ApplyHolsterFix()
 
 void ClearResultCaches()
 {
-	g_animationResultCache.clear();
-	g_animPathFrameCache.clear();
-	g_scriptCache.clear();
-}
-
-void SynchronizedQueue::Add(std::function<void()>&& func)
-{
-	std::unique_lock lock(mutex);
-	queue.push_back(std::move(func));
-}
-
-void SynchronizedQueue::RunAllAndClear()
-{
-	// std::unique_lock lock(mutex);
-	// Not needed
-	DebugAssert(!AILinearTaskManager::ShouldQueue3DTask());
-	while (!queue.empty())
-	{
-		queue.front()();
-		queue.pop_front();
-	}
+	g_animationResultCache.Clear();
+	g_animPathFrameCache.Clear();
+	g_scriptCache.Clear();
 }
 
 void HandleMisc()
@@ -710,6 +604,8 @@ void HandleMisc()
 	ApplyHolsterFix();
 	OnReloadHandler::Update();
 	ClearResultCaches();
+	// after the result caches, they may still point at anims that get evicted
+	EvictCustomAnims();
 }
 
 std::thread g_animFileThread;
@@ -755,12 +651,16 @@ void MessageHandler(NVSEMessagingInterface::Message* msg)
 			}
 #endif
 		}
-		HandleSynchronizedExecutionQueue();
-		g_mainThreadQueue.RunAllAndClear(); // kMessage_MainGameLoop runs before AILinearTaskThreads start
+		DebugAssert(!AILinearTaskManager::ShouldQueue3DTask());
+		g_mainThreadQueue.RunAll(); // kMessage_MainGameLoop runs before AILinearTaskThreads start
 	}
 	else if (msg->type == NVSEMessagingInterface::kMessage_PostLoadGame)
 	{
 	}
+	else if (msg->type == NVSEMessagingInterface::kMessage_ExitGame || msg->type == NVSEMessagingInterface::kMessage_ExitGame_Console)
+	{
+		IDebugLog::Flush();
+	}
 }
 
 
@@ -862,6 +762,9 @@ bool NVSEPlugin_Load(const NVSEInterface* nvse)
 		return true;
 	}
 
+	// LoadFileAnimPaths and the animation error hooks log a lot, keep the file writes off those threads
+	IDebugLog::SetAsync(true);
+
 	g_eventManagerInterface = (NVSEEventManagerInterface*)nvse->QueryInterface(kInterface_EventManager);
 
 	//g_eventManagerInterface->SetNativeEventHandler("OnActorEquip", OnActorEquipEventHandler);
@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <functional>
 #include <deque>
 #include <PluginAPI.h>
@@ -6,6 +7,7 @@
 #include <thread>
 
 #include "commands_animation.h"
+#include "task_queue.h"
 
 struct CustomAnimGroupScript
 {
@@ -27,21 +29,22 @@ struct CustomAnimGroupScript
 extern NVSEScriptInterface* g_script;
 extern NVSECommandTableInterface* g_cmdTable;
 
-extern std::deque<std::function<void()>> g_synchronizedExecutionQueue;
-extern ICriticalSection g_executionQueueCS;
 extern NVSEArrayVarInterface* g_arrayVarInterface;
 extern NVSEStringVarInterface* g_stringVarInterface;
 extern std::unordered_map<std::string, std::vector<CustomAnimGroupScript>> g_customAnimGroups;
 using AnimGroupPathsMap = std::unordered_map<std::string, std::unordered_set<std::string>, transparent_string_hash, std::equal_to<>>;
 extern AnimGroupPathsMap g_customAnimGroupPaths;
-extern std::map<std::pair<FullAnimGroupID, AnimData*>, std::deque<BSAnimGroupSequence*>> g_queuedReplaceAnims;
+extern QueuedAnimStore g_queuedReplaceAnims;
 extern std::vector<std::string> g_eachFrameScriptLines;
 extern std::thread g_animFileThread;
 extern std::recursive_mutex g_pollConditionMutex;
+extern BSAnimGroupSequence* g_fixHolsterUnequipAnim3rd;
 
 void Revert3rdPersonAnimTimes(BSAnimGroupSequence* anim3rd, BSAnimGroupSequence* anim1st);
 void Set3rdPersonAnimTimes(BSAnimGroupSequence* anim3rd, BSAnimGroupSequence* anim1st);
 void Save3rdPersonAnimGroupData(BSAnimGroupSequence* anim3rd);
+// the anim is about to be unloaded, its address may be reused by the next one
+void Erase3rdPersonAnimGroupData(BSAnimGroupSequence* anim3rd);
 
 bool IsGodMode();
 
@@ -87,18 +90,24 @@ struct ScriptPairEqual {
 
 using ScriptCacheKey = std::pair<TESObjectREFR*, Script*>;
 using ScriptCacheValue = NVSEArrayVarInterface::Element;
-using ScriptCache = ResultCache<const ScriptCacheKey, ScriptCacheValue, ScriptPairHash, ScriptPairEqual>;
+using ScriptCache = ResultCache<ScriptCacheKey, ScriptCacheValue, ScriptPairHash, ScriptPairEqual>;
 
 struct MapHitCounter
 {
 	const char* name;
-	int hits = 0;
-	int misses = 0;
-	int total = 0;
+	std::atomic<int> hits = 0;
+	std::atomic<int> misses = 0;
+	std::atomic<int> total = 0;
+
+	void Record(bool hit)
+	{
+		++(hit ? hits : misses);
+		++total;
+	}
 
 	void Print()
 	{
-		Console_Print("%s Hits: %d misses: %d total: %d", name, hits, misses, total);
+		Console_Print("%s Hits: %d misses: %d total: %d", name, hits.load(), misses.load(), total.load());
 		hits = 0;
 		misses = 0;
 		total = 0;
@@ -109,34 +118,87 @@ struct MapHitCounters
 {
 	MapHitCounter getActorAnimation{"GetActorAnimation"};
 	MapHitCounter scriptCall{"ScriptCall"};
+	MapHitCounter animPath{"AnimPathFrame"};
+	MapHitCounter directoryIndex{"DirectoryIndex"};
 };
 
 extern MapHitCounters g_mapHitCounters;
 
+struct LockContentionCounter
+{
+	const char* name;
+	std::atomic<UInt32> acquisitions = 0;
+	std::atomic<UInt32> contended = 0;
+
+	void Print()
+	{
+		Console_Print("%s Lock acquisitions: %u contended: %u", name, acquisitions.load(), contended.load());
+		acquisitions = 0;
+		contended = 0;
+	}
+};
+
+struct LockContentionCounters
+{
+	LockContentionCounter customAnimLookup{"CustomAnimLookup"};
+	LockContentionCounter customAnimBind{"CustomAnimBind"};
+};
+
+extern LockContentionCounters g_lockContentionCounters;
+
+// acquires the lock and records whether another thread was holding it
+template <typename Mutex>
+std::unique_lock<Mutex> LockCounted(Mutex& mutex, LockContentionCounter& counter)
+{
+	std::unique_lock lock(mutex, std::try_to_lock);
+	++counter.acquisitions;
+	if (!lock.owns_lock())
+	{
+		++counter.contended;
+		lock.lock();
+	}
+	return lock;
+}
+
+template <typename Mutex>
+std::shared_lock<Mutex> SharedLockCounted(Mutex& mutex, LockContentionCounter& counter)
+{
+	std::shared_lock lock(mutex, std::try_to_lock);
+	++counter.acquisitions;
+	if (!lock.owns_lock())
+	{
+		++counter.contended;
+		lock.lock();
+	}
+	return lock;
+}
+
 struct AverageTimer
 {
 	const char* name;
-	unsigned int count = 0;
-	std::chrono::high_resolution_clock::duration totalDuration = std::chrono::high_resolution_clock::duration::zero();
+	// timed functions run on more than one thread
+	std::atomic<unsigned int> count = 0;
+	std::atomic<long long> totalNanoseconds = 0;
 
 	void Add(std::chrono::high_resolution_clock::duration duration)
 	{
-		count++;
-		totalDuration += duration;
+		totalNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+		++count;
 	}
 
 	void Print()
 	{
-		if (count == 0)
+		const unsigned int numCalls = count;
+		if (numCalls == 0)
 			return;
-		long long average = std::chrono::duration_cast<std::chrono::nanoseconds>(totalDuration).count() / count;
+		long long average = totalNanoseconds / numCalls;
 		char buf[0x100];
 		sprintf_s(buf, 0x100, "%lld ns", average);
-		Console_Print("%s", buf);
-		if (count % 1000 == 0)
+		Console_Print("%s %s", name, buf);
+		if (numCalls % 1000 == 0)
 		{
 			count = 0;
-			totalDuration = std::chrono::high_resolution_clock::duration::zero();
+			totalNanoseconds = 0;
 		}
 	}
 };
@@ -163,18 +225,11 @@ struct FunctionTimer
 struct AverageTimers
 {
 	AverageTimer getActorAnimation{"GetActorAnimation"};
+	AverageTimer setOverrideAnimation{"SetOverrideAnimation"};
+	AverageTimer handleBurstFire{"HandleBurstFire"};
 };
 
 extern AverageTimers g_averageTimers;
 
 void ClearResultCaches();
 
-class SynchronizedQueue
-{
-	std::deque<std::function<void()>> queue;
-	std::mutex mutex;
-public:
-	void Add(std::function<void()>&& func);
-	void RunAllAndClear();
-};
-extern SynchronizedQueue g_mainThreadQueue;
@@ -0,0 +1,65 @@
+#pragma once
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+// Reverse index from an owner (actor, AnimData) to the keys it holds in some container, so that whatever an owner
+// left behind can be erased without scanning the whole container. Not synchronized, it is guarded by the same lock
+// as the container it indexes.
+template <typename Owner, typename Key>
+class OwnerIndex
+{
+	std::unordered_map<Owner, std::vector<Key>> keysByOwner;
+
+public:
+	void Add(Owner owner, const Key& key)
+	{
+		auto& keys = keysByOwner[owner];
+		if (std::ranges::find(keys, key) == keys.end())
+			keys.push_back(key);
+	}
+
+	void Remove(Owner owner, const Key& key)
+	{
+		const auto iter = keysByOwner.find(owner);
+		if (iter == keysByOwner.end())
+			return;
+		auto& keys = iter->second;
+		if (const auto keyIter = std::ranges::find(keys, key); keyIter != keys.end())
+		{
+			*keyIter = std::move(keys.back());
+			keys.pop_back();
+		}
+		if (keys.empty())
+			keysByOwner.erase(iter);
+	}
+
+	// keys move to a new owner when a container entry is taken over
+	void Transfer(Owner from, Owner to, const Key& key)
+	{
+		if (from == to)
+			return;
+		Remove(from, key);
+		Add(to, key);
+	}
+
+	std::vector<Key> Take(Owner owner)
+	{
+		const auto iter = keysByOwner.find(owner);
+		if (iter == keysByOwner.end())
+			return {};
+		auto keys = std::move(iter->second);
+		keysByOwner.erase(iter);
+		return keys;
+	}
+
+	void Clear()
+	{
+		keysByOwner.clear();
+	}
+
+	size_t NumOwners() const
+	{
+		return keysByOwner.size();
+	}
+};
@@ -0,0 +1,98 @@
+#include "queued_anim_store.h"
+
+void QueuedAnimStore::FreeNodes(const Queue& queue)
+{
+	for (auto index = queue.head; index != kNone;)
+	{
+		const auto next = nodes[index].next;
+		nodes[index].next = freeNodes;
+		freeNodes = index;
+		--numQueued;
+		index = next;
+	}
+}
+
+void QueuedAnimStore::Push(AnimData* animData, FullAnimGroupID groupId, BSAnimGroupSequence* anim)
+{
+	std::unique_lock lock(mutex);
+	UInt32 index = freeNodes;
+	if (index != kNone)
+	{
+		freeNodes = nodes[index].next;
+		nodes[index] = { anim, kNone };
+	}
+	else
+	{
+		index = nodes.size();
+		nodes.push_back({ anim, kNone });
+	}
+	const auto [iter, isNew] = queues.try_emplace(std::make_pair(animData, groupId));
+	if (isNew)
+		groupsByAnimData.Add(animData, groupId);
+	auto& queue = iter->second;
+	if (queue.tail != kNone)
+		nodes[queue.tail].next = index;
+	else
+		queue.head = index;
+	queue.tail = index;
+	++numQueued;
+}
+
+BSAnimGroupSequence* QueuedAnimStore::Pop(AnimData* animData, FullAnimGroupID groupId)
+{
+	if (!numQueued)
+		return nullptr;
+	std::unique_lock lock(mutex);
+	const auto iter = queues.find(std::make_pair(animData, groupId));
+	if (iter == queues.end() || iter->second.head == kNone)
+		return nullptr;
+	auto& queue = iter->second;
+	const auto index = queue.head;
+	auto& node = nodes[index];
+	queue.head = node.next;
+	if (queue.head == kNone)
+		queue.tail = kNone;
+	node.next = freeNodes;
+	freeNodes = index;
+	--numQueued;
+	return node.anim;
+}
+
+bool QueuedAnimStore::Contains(AnimData* animData, FullAnimGroupID groupId, BSAnimGroupSequence* anim)
+{
+	if (!numQueued)
+		return false;
+	std::unique_lock lock(mutex);
+	const auto iter = queues.find(std::make_pair(animData, groupId));
+	if (iter == queues.end())
+		return false;
+	for (auto index = iter->second.head; index != kNone; index = nodes[index].next)
+	{
+		if (nodes[index].anim == anim)
+			return true;
+	}
+	return false;
+}
+
+void QueuedAnimStore::EraseAnimData(AnimData* animData)
+{
+	std::unique_lock lock(mutex);
+	for (const auto groupId : groupsByAnimData.Take(animData))
+	{
+		const auto iter = queues.find(std::make_pair(animData, groupId));
+		if (iter == queues.end())
+			continue;
+		FreeNodes(iter->second);
+		queues.erase(iter);
+	}
+}
+
+void QueuedAnimStore::Clear()
+{
+	std::unique_lock lock(mutex);
+	queues.clear();
+	groupsByAnimData.Clear();
+	nodes.clear();
+	freeNodes = kNone;
+	numQueued = 0;
+}
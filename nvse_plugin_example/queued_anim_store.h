@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "owner_index.h"
+
+struct AnimData;
+class BSAnimGroupSequence;
+
+using FullAnimGroupID = UInt16;
+
+// FIFO queues of QueueNextAnim anims per AnimData and anim group. Entries are nodes of a pooled list so queueing doesn't
+// allocate once warmed up, and every queue of an AnimData is dropped along with the AnimData.
+// Only stores the pointers and never dereferences them, queued_anim_store_test.cpp churns it outside the game.
+class QueuedAnimStore
+{
+	static constexpr UInt32 kNone = 0xFFFFFFFF;
+
+	struct Node
+	{
+		BSAnimGroupSequence* anim;
+		UInt32 next;
+	};
+
+	struct Queue
+	{
+		UInt32 head = kNone;
+		UInt32 tail = kNone;
+	};
+
+	using Key = std::pair<AnimData*, FullAnimGroupID>;
+
+	struct KeyHash
+	{
+		size_t operator()(const Key& key) const
+		{
+			return std::hash<AnimData*>()(key.first) * 31 + key.second;
+		}
+	};
+
+	std::mutex mutex;
+	// checked without the lock so animation changes skip it while nothing is queued
+	std::atomic<UInt32> numQueued = 0;
+	// empty queues are kept until their AnimData goes away
+	std::unordered_map<Key, Queue, KeyHash> queues;
+	OwnerIndex<AnimData*, FullAnimGroupID> groupsByAnimData;
+	std::vector<Node> nodes;
+	UInt32 freeNodes = kNone;
+
+	void FreeNodes(const Queue& queue);
+public:
+	void Push(AnimData* animData, FullAnimGroupID groupId, BSAnimGroupSequence* anim);
+	BSAnimGroupSequence* Pop(AnimData* animData, FullAnimGroupID groupId);
+	bool Contains(AnimData* animData, FullAnimGroupID groupId, BSAnimGroupSequence* anim);
+	void EraseAnimData(AnimData* animData);
+	void Clear();
+	UInt32 Size() const { return numQueued; }
+};
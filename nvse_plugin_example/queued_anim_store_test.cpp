@@ -0,0 +1,108 @@
+// Standalone churn test for QueuedAnimStore, not part of the plugin build. Many actors queue, pop, look up and drop
+// anims at random and every result is checked against a plain map of deques; the threaded pass does the same with
+// each thread owning its own actors so the store's lock is contended. Build and run it with any C++20 compiler, e.g.
+//   g++ -std=c++20 -g -fsanitize=address,undefined queued_anim_store_test.cpp && ./a.out
+//   g++ -std=c++20 -g -fsanitize=thread queued_anim_store_test.cpp && ./a.out
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <random>
+#include <thread>
+
+// stand-ins for what nvse/prefix.h and the game headers provide in the plugin build
+typedef std::uint16_t UInt16;
+typedef std::uint32_t UInt32;
+
+struct AnimData {};
+class BSAnimGroupSequence {};
+
+#include "queued_anim_store.h"
+#include "queued_anim_store.cpp"
+
+#define CHECK(cond) \
+	if (!(cond)) \
+	{ \
+		std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		std::abort(); \
+	}
+
+namespace
+{
+	using Reference = std::map<std::pair<AnimData*, FullAnimGroupID>, std::deque<BSAnimGroupSequence*>>;
+
+	std::vector<BSAnimGroupSequence> g_anims(50);
+
+	// drains whatever is left queued at the end, so the store is empty again afterwards
+	void Churn(QueuedAnimStore& store, std::vector<AnimData>& actors, UInt32 seed, int numOps)
+	{
+		Reference reference;
+		std::mt19937 rng(seed);
+		for (int i = 0; i < numOps; ++i)
+		{
+			auto* animData = &actors[rng() % actors.size()];
+			const FullAnimGroupID groupId = rng() % 8;
+			auto* anim = &g_anims[rng() % g_anims.size()];
+			auto& queue = reference[std::make_pair(animData, groupId)];
+			const auto op = rng() % 100;
+			if (op < 45)
+			{
+				store.Push(animData, groupId, anim);
+				queue.push_back(anim);
+			}
+			else if (op < 90)
+			{
+				BSAnimGroupSequence* expected = nullptr;
+				if (!queue.empty())
+				{
+					expected = queue.front();
+					queue.pop_front();
+				}
+				CHECK(store.Pop(animData, groupId) == expected);
+			}
+			else if (op < 99)
+			{
+				CHECK(store.Contains(animData, groupId, anim) == (std::ranges::find(queue, anim) != queue.end()));
+			}
+			else
+			{
+				store.EraseAnimData(animData);
+				std::erase_if(reference, [&](const auto& entry) { return entry.first.first == animData; });
+			}
+		}
+		for (const auto& [key, queue] : reference)
+		{
+			for (auto* anim : queue)
+				CHECK(store.Pop(key.first, key.second) == anim);
+			CHECK(store.Pop(key.first, key.second) == nullptr);
+		}
+	}
+}
+
+int main()
+{
+	{
+		QueuedAnimStore store;
+		std::vector<AnimData> actors(200);
+		Churn(store, actors, 1, 2000000);
+		CHECK(store.Size() == 0);
+	}
+	{
+		constexpr int kNumThreads = 8;
+		QueuedAnimStore store;
+		std::vector<std::vector<AnimData>> actors(kNumThreads, std::vector<AnimData>(50));
+		std::vector<std::thread> threads;
+		for (int i = 0; i < kNumThreads; ++i)
+			threads.emplace_back([&, i] { Churn(store, actors[i], i + 100, 200000); });
+		for (auto& thread : threads)
+			thread.join();
+		CHECK(store.Size() == 0);
+		store.Push(&actors[0][0], 0, &g_anims[0]);
+		store.Clear();
+		CHECK(store.Size() == 0 && store.Pop(&actors[0][0], 0) == nullptr);
+	}
+	std::puts("QueuedAnimStore churn passed");
+	return 0;
+}
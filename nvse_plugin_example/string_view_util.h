@@ -39,6 +39,19 @@ namespace sv
         return _stricmp(left.data(), right.data()) == 0;
     }
 
+    // 64-bit FNV-1a over the lowercased characters
+    constexpr UInt64 hash_ci(std::string_view str)
+    {
+        UInt64 hash = 0xCBF29CE484222325ull;
+        for (const char c : str)
+        {
+            const auto lower = c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+            hash ^= static_cast<unsigned char>(lower);
+            hash *= 0x100000001B3ull;
+        }
+        return hash;
+    }
+
     inline bool contains_ci(std::string_view left, std::string_view right)
     {
         return FindStringCI(left, right);
@@ -0,0 +1,202 @@
+#include "task_queue.h"
+#include "GameAPI.h"
+
+MainThreadTaskQueue g_mainThreadQueue("MainThreadQueue");
+WorkerPool g_workerPool("WorkerPool", max(1u, min(4u, std::thread::hardware_concurrency() / 2)));
+
+void TaskQueueStats::Print()
+{
+	const auto runCount = numRun.load();
+	Console_Print("%s queued: %u depth: %u peak depth: %u avg latency: %lld us max latency: %lld us", name, enqueued.load(), depth.load(),
+		peakDepth.load(), runCount ? totalLatencyUs.load() / runCount : 0, maxLatencyUs.load());
+	enqueued = 0;
+	peakDepth = depth.load();
+	numRun = 0;
+	totalLatencyUs = 0;
+	maxLatencyUs = 0;
+}
+
+MainThreadTaskQueue::MainThreadTaskQueue(const char* name) : stats{name}
+{
+	for (UInt32 i = 0; i < kCapacity; ++i)
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+bool MainThreadTaskQueue::TryPushRing(Task& task)
+{
+	UInt32 pos = writePos.load(std::memory_order_relaxed);
+	Slot* slot;
+	while (true)
+	{
+		slot = &slots[pos % kCapacity];
+		const auto diff = static_cast<SInt32>(slot->sequence.load(std::memory_order_acquire) - pos);
+		if (diff == 0)
+		{
+			if (writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return false; // full
+		else
+			pos = writePos.load(std::memory_order_relaxed);
+	}
+	slot->task = std::move(task);
+	slot->queuedAt = TaskQueueStats::Clock::now();
+	slot->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+bool MainThreadTaskQueue::TryPopRing(Task& task, TaskQueueStats::Clock::time_point& queuedAt)
+{
+	Slot& slot = slots[readPos % kCapacity];
+	if (slot.sequence.load(std::memory_order_acquire) != readPos + 1)
+		return false;
+	task = std::move(slot.task);
+	queuedAt = slot.queuedAt;
+	slot.sequence.store(readPos + kCapacity, std::memory_order_release);
+	++readPos;
+	return true;
+}
+
+void MainThreadTaskQueue::Push(Task&& task)
+{
+	stats.OnEnqueue();
+	if (!overflowActive.load(std::memory_order_acquire) && TryPushRing(task))
+		return;
+	std::unique_lock lock(overflowMutex);
+	overflow.emplace_back(std::move(task), TaskQueueStats::Clock::now());
+	overflowActive = true;
+}
+
+void MainThreadTaskQueue::RunAll()
+{
+	Task task;
+	TaskQueueStats::Clock::time_point queuedAt;
+	while (true)
+	{
+		if (TryPopRing(task, queuedAt))
+		{
+			stats.OnDequeue(queuedAt);
+			task();
+			task.Reset();
+			continue;
+		}
+		// everything in the ring was queued before the overflow list was started
+		decltype(overflow) batch;
+		{
+			std::unique_lock lock(overflowMutex);
+			if (overflow.empty())
+			{
+				overflowActive = false;
+				return;
+			}
+			batch.swap(overflow);
+		}
+		for (auto& [overflowTask, overflowQueuedAt] : batch)
+		{
+			stats.OnDequeue(overflowQueuedAt);
+			overflowTask();
+		}
+	}
+}
+
+WorkerPool::WorkerPool(const char* name, UInt32 numThreads) : stats{name}, numThreads(numThreads)
+{
+	for (UInt32 i = 0; i < numThreads; ++i)
+		workers.push_back(std::make_unique<Worker>());
+}
+
+WorkerPool::~WorkerPool()
+{
+	// not joined, this runs during DLL detach where the workers may already be gone
+	stopping = true;
+	wakeCondition.notify_all();
+}
+
+void WorkerPool::Start()
+{
+	for (UInt32 i = 0; i < numThreads; ++i)
+		std::thread(&WorkerPool::Run, this, i).detach();
+}
+
+void WorkerPool::Push(Task&& task)
+{
+	std::call_once(startFlag, &WorkerPool::Start, this);
+	stats.OnEnqueue();
+	auto& worker = *workers[nextWorker++ % numThreads];
+	{
+		std::unique_lock lock(worker.mutex);
+		worker.entries.push_back({std::move(task), TaskQueueStats::Clock::now()});
+	}
+	bool wakeAll;
+	{
+		std::unique_lock lock(sleepMutex);
+		++numPending;
+		++pushGeneration;
+		wakeAll = numRetrying != 0;
+	}
+	if (wakeAll)
+		wakeCondition.notify_all();
+	else
+		wakeCondition.notify_one();
+}
+
+bool WorkerPool::TryTake(UInt32 index, Entry& out)
+{
+	// own work newest first, stolen work oldest first
+	{
+		auto& worker = *workers[index];
+		std::unique_lock lock(worker.mutex);
+		if (!worker.entries.empty())
+		{
+			out = std::move(worker.entries.back());
+			worker.entries.pop_back();
+			return true;
+		}
+	}
+	for (UInt32 i = 1; i < numThreads; ++i)
+	{
+		auto& victim = *workers[(index + i) % numThreads];
+		std::unique_lock lock(victim.mutex);
+		if (!victim.entries.empty())
+		{
+			out = std::move(victim.entries.front());
+			victim.entries.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void WorkerPool::Run(UInt32 index)
+{
+	Entry entry;
+	while (!stopping)
+	{
+		UInt32 seenGeneration;
+		{
+			std::unique_lock lock(sleepMutex);
+			wakeCondition.wait(lock, [&] { return numPending > 0 || stopping; });
+			if (stopping)
+				return;
+			--numPending;
+			seenGeneration = pushGeneration;
+		}
+		// a pending count was claimed, so some deque holds a task for this thread; the scan can still miss it when
+		// a later push lands in a deque that was already looked at while another thread takes the one ahead, in
+		// which case there has been a push since seenGeneration
+		while (!TryTake(index, entry))
+		{
+			std::unique_lock lock(sleepMutex);
+			++numRetrying;
+			wakeCondition.wait(lock, [&] { return pushGeneration != seenGeneration || stopping; });
+			--numRetrying;
+			if (stopping)
+				return;
+			seenGeneration = pushGeneration;
+		}
+		stats.OnDequeue(entry.queuedAt);
+		entry.task();
+		entry.task.Reset();
+	}
+}
@@ -0,0 +1,266 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <condition_variable>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Type erased void() callable. Callables up to kInlineSize bytes are stored in place, so queueing a typical lambda
+// does not allocate; larger ones are moved to the heap.
+class Task
+{
+public:
+	static constexpr size_t kInlineSize = 112;
+
+	Task() = default;
+
+	template <typename F, typename Fn = std::decay_t<F>, typename = std::enable_if_t<!std::is_same_v<Fn, Task>>>
+	Task(F&& func)
+	{
+		if constexpr (sizeof(Fn) <= kInlineSize && alignof(Fn) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Fn>)
+		{
+			new (storage) Fn(std::forward<F>(func));
+			ops = &InlineOps<Fn>::ops;
+		}
+		else
+		{
+			*reinterpret_cast<Fn**>(storage) = new Fn(std::forward<F>(func));
+			ops = &HeapOps<Fn>::ops;
+		}
+	}
+
+	Task(Task&& other) noexcept
+	{
+		MoveFrom(other);
+	}
+
+	Task& operator=(Task&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			MoveFrom(other);
+		}
+		return *this;
+	}
+
+	Task(const Task&) = delete;
+	Task& operator=(const Task&) = delete;
+
+	~Task()
+	{
+		Reset();
+	}
+
+	void operator()()
+	{
+		ops->invoke(storage);
+	}
+
+	explicit operator bool() const
+	{
+		return ops != nullptr;
+	}
+
+	void Reset()
+	{
+		if (ops)
+		{
+			ops->destroy(storage);
+			ops = nullptr;
+		}
+	}
+
+private:
+	struct Ops
+	{
+		void (*invoke)(void* storage);
+		void (*move)(void* dest, void* src);
+		void (*destroy)(void* storage);
+	};
+
+	template <typename Fn>
+	struct InlineOps
+	{
+		static void Invoke(void* storage) { (*static_cast<Fn*>(storage))(); }
+		static void Move(void* dest, void* src) { new (dest) Fn(std::move(*static_cast<Fn*>(src))); static_cast<Fn*>(src)->~Fn(); }
+		static void Destroy(void* storage) { static_cast<Fn*>(storage)->~Fn(); }
+		static constexpr Ops ops{Invoke, Move, Destroy};
+	};
+
+	template <typename Fn>
+	struct HeapOps
+	{
+		static void Invoke(void* storage) { (**static_cast<Fn**>(storage))(); }
+		static void Move(void* dest, void* src) { *static_cast<Fn**>(dest) = *static_cast<Fn**>(src); }
+		static void Destroy(void* storage) { delete *static_cast<Fn**>(storage); }
+		static constexpr Ops ops{Invoke, Move, Destroy};
+	};
+
+	void MoveFrom(Task& other)
+	{
+		ops = other.ops;
+		if (ops)
+		{
+			ops->move(storage, other.storage);
+			other.ops = nullptr;
+		}
+	}
+
+	alignas(std::max_align_t) unsigned char storage[kInlineSize];
+	const Ops* ops = nullptr;
+};
+
+struct TaskQueueStats
+{
+	using Clock = std::chrono::steady_clock;
+
+	const char* name;
+	std::atomic<UInt32> enqueued = 0;
+	std::atomic<UInt32> depth = 0;
+	std::atomic<UInt32> peakDepth = 0;
+	std::atomic<UInt32> numRun = 0;
+	std::atomic<long long> totalLatencyUs = 0;
+	std::atomic<long long> maxLatencyUs = 0;
+
+	void OnEnqueue()
+	{
+		++enqueued;
+		const auto newDepth = ++depth;
+		auto peak = peakDepth.load(std::memory_order_relaxed);
+		while (newDepth > peak && !peakDepth.compare_exchange_weak(peak, newDepth, std::memory_order_relaxed)) {}
+	}
+
+	// called right before the task runs
+	void OnDequeue(Clock::time_point queuedAt)
+	{
+		--depth;
+		++numRun;
+		const auto latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - queuedAt).count();
+		totalLatencyUs += latencyUs;
+		auto maxLatency = maxLatencyUs.load(std::memory_order_relaxed);
+		while (latencyUs > maxLatency && !maxLatencyUs.compare_exchange_weak(maxLatency, latencyUs, std::memory_order_relaxed)) {}
+	}
+
+	void Print();
+};
+
+// Multi-producer queue for work that has to run on the main thread. Producers claim a slot of a fixed ring with a
+// CAS and never take a lock; if the ring is full they fall back to a locked overflow list, which is then used by
+// every producer until the main thread has drained it so that FIFO order is kept.
+class MainThreadTaskQueue
+{
+public:
+	explicit MainThreadTaskQueue(const char* name);
+
+	template <typename F>
+	void Add(F&& func)
+	{
+		Push(Task(std::forward<F>(func)));
+	}
+
+	void Push(Task&& task);
+
+	// main thread only, also runs tasks that are queued while draining
+	void RunAll();
+
+	TaskQueueStats stats;
+
+private:
+	enum { kCapacity = 256 };
+
+	struct Slot
+	{
+		std::atomic<UInt32> sequence;
+		Task task;
+		TaskQueueStats::Clock::time_point queuedAt;
+	};
+
+	bool TryPushRing(Task& task);
+	bool TryPopRing(Task& task, TaskQueueStats::Clock::time_point& queuedAt);
+
+	Slot slots[kCapacity];
+	std::atomic<UInt32> writePos = 0;
+	UInt32 readPos = 0;
+
+	std::mutex overflowMutex;
+	std::deque<std::pair<Task, TaskQueueStats::Clock::time_point>> overflow;
+	std::atomic<bool> overflowActive = false;
+};
+
+// Worker threads for work that does not touch game state (file reading, parsing, hashing). Each worker has its own
+// deque; submissions are spread round robin and an idle worker steals from the others.
+class WorkerPool
+{
+public:
+	WorkerPool(const char* name, UInt32 numThreads);
+	~WorkerPool();
+
+	template <typename F, typename R = std::invoke_result_t<std::decay_t<F>&>>
+	std::future<R> Submit(F&& func)
+	{
+		auto promise = std::make_shared<std::promise<R>>();
+		auto future = promise->get_future();
+		Push(Task([promise, func = std::forward<F>(func)]() mutable
+		{
+			try
+			{
+				if constexpr (std::is_void_v<R>)
+				{
+					func();
+					promise->set_value();
+				}
+				else
+					promise->set_value(func());
+			}
+			catch (...)
+			{
+				promise->set_exception(std::current_exception());
+			}
+		}));
+		return future;
+	}
+
+	void Push(Task&& task);
+
+	TaskQueueStats stats;
+
+private:
+	struct Entry
+	{
+		Task task;
+		TaskQueueStats::Clock::time_point queuedAt;
+	};
+
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<Entry> entries;
+	};
+
+	void Start();
+	void Run(UInt32 index);
+	bool TryTake(UInt32 index, Entry& out);
+
+	UInt32 numThreads;
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::once_flag startFlag;
+	std::atomic<UInt32> nextWorker = 0;
+	std::atomic<UInt32> numPending = 0;
+	std::mutex sleepMutex;
+	// both guarded by sleepMutex; lets a worker that claimed a task but lost the race for it sleep until the next push
+	UInt32 pushGeneration = 0;
+	UInt32 numRetrying = 0;
+	std::condition_variable wakeCondition;
+	std::atomic<bool> stopping = false;
+};
+
+extern MainThreadTaskQueue g_mainThreadQueue;
+extern WorkerPool g_workerPool;
@@ -0,0 +1,75 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <vector>
+
+// Hashed timer wheel: scheduling is O(1) and advancing only visits the slots of the ticks that passed, so nothing
+// is done for timers that aren't due. Time is whatever the caller passes in (frame counter, fake clock in a test),
+// the wheel never reads a clock itself. Not synchronized.
+template <typename T, UInt32 NumSlots = 64>
+class TimerWheel
+{
+	struct Timer
+	{
+		UInt32 due;
+		T value;
+	};
+
+	std::array<std::vector<Timer>, NumSlots> slots;
+	std::vector<T> fired;
+	UInt32 now = 0;
+	UInt32 numTimers = 0;
+
+public:
+	explicit TimerWheel(UInt32 start = 0) : now(start) {}
+
+	// due is absolute and has to be later than the time last passed to Advance
+	void Schedule(UInt32 due, const T& value)
+	{
+		slots[due % NumSlots].push_back({ due, value });
+		++numTimers;
+	}
+
+	// fires every timer due at or before time in order of their slots; f may schedule new timers
+	template <typename F>
+	void Advance(UInt32 time, F&& f)
+	{
+		if (!numTimers)
+		{
+			now = time;
+			return;
+		}
+		// a slot holds timers of later rounds too, so a jump of a whole round or more visits every slot once
+		const UInt32 steps = std::min<UInt32>(time - now, NumSlots);
+		for (UInt32 i = 1; i <= steps; ++i)
+		{
+			auto& slot = slots[(now + i) % NumSlots];
+			for (size_t j = 0; j < slot.size();)
+			{
+				if (static_cast<int>(slot[j].due - time) <= 0)
+				{
+					fired.push_back(std::move(slot[j].value));
+					slot[j] = std::move(slot.back());
+					slot.pop_back();
+					--numTimers;
+				}
+				else
+					++j;
+			}
+		}
+		now = time;
+		for (auto& value : fired)
+			f(value);
+		fired.clear();
+	}
+
+	void Clear()
+	{
+		for (auto& slot : slots)
+			slot.clear();
+		numTimers = 0;
+	}
+
+	UInt32 Size() const { return numTimers; }
+	UInt32 Now() const { return now; }
+};
@@ -0,0 +1,100 @@
+// Standalone test for TimerWheel, not part of the plugin build. A fake clock schedules timers and advances by single
+// ticks, small steps and jumps of more than a round at random; what fires is checked against a multimap of due
+// times, including timers scheduled from the callback and a clock that wraps around. Build and run it with any C++20
+// compiler, e.g.
+//   g++ -std=c++20 -g -fsanitize=address,undefined timer_wheel_test.cpp && ./a.out
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <set>
+
+// stand-in for what nvse/prefix.h provides in the plugin build
+typedef std::uint32_t UInt32;
+
+#include "timer_wheel.h"
+
+#define CHECK(cond) \
+	if (!(cond)) \
+	{ \
+		std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		std::abort(); \
+	}
+
+namespace
+{
+	void Churn(UInt32 start, UInt32 seed)
+	{
+		constexpr UInt32 kNumSlots = 16;
+		std::mt19937 rng(seed);
+		TimerWheel<int, kNumSlots> wheel(start);
+		std::multimap<UInt32, int> reference; // keyed by due - start so that ordering survives the clock wrapping
+		UInt32 now = start;
+		int nextId = 0;
+		for (int step = 0; step < 2000; ++step)
+		{
+			if (rng() % 3 != 0)
+			{
+				const UInt32 due = now + 1 + rng() % (3 * kNumSlots);
+				wheel.Schedule(due, nextId);
+				reference.emplace(due - start, nextId);
+				++nextId;
+				continue;
+			}
+			// mostly a tick or two like frames, sometimes a jump past a whole round
+			const UInt32 time = now + (rng() % 5 == 0 ? rng() % (4 * kNumSlots) : rng() % 3);
+			std::multiset<int> fired;
+			wheel.Advance(time, [&](int id)
+			{
+				fired.insert(id);
+				// rescheduling from the callback must land after time
+				if (id % 7 == 0)
+				{
+					const UInt32 due = time + 1 + id % 5;
+					wheel.Schedule(due, -id - 1);
+					reference.emplace(due - start, -id - 1);
+				}
+			});
+			std::multiset<int> expected;
+			for (auto iter = reference.begin(); iter != reference.end() && iter->first <= time - start;)
+			{
+				expected.insert(iter->second);
+				iter = reference.erase(iter);
+			}
+			CHECK(fired == expected);
+			CHECK(wheel.Size() == reference.size());
+			CHECK(wheel.Now() == time);
+			now = time;
+		}
+		wheel.Clear();
+		CHECK(wheel.Size() == 0);
+		wheel.Advance(now + 4 * kNumSlots, [](int) { CHECK(false); });
+	}
+
+	void TestIdle()
+	{
+		// an empty wheel only moves its clock
+		TimerWheel<int, 8> wheel;
+		wheel.Advance(100, [](int) { CHECK(false); });
+		CHECK(wheel.Now() == 100);
+		wheel.Schedule(103, 1);
+		int numFired = 0;
+		wheel.Advance(102, [&](int) { ++numFired; });
+		CHECK(numFired == 0);
+		wheel.Advance(500, [&](int value) { CHECK(value == 1); ++numFired; });
+		CHECK(numFired == 1 && wheel.Size() == 0);
+	}
+}
+
+int main()
+{
+	for (UInt32 seed = 1; seed <= 200; ++seed)
+		Churn(1000, seed);
+	// the clock wraps around during these
+	for (UInt32 seed = 1; seed <= 50; ++seed)
+		Churn(0xFFFFFFFF - 500, seed);
+	TestIdle();
+	std::puts("TimerWheel passed");
+	return 0;
+}
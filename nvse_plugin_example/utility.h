@@ -356,6 +356,10 @@ std::string DecompileScript(Script* script);
 std::filesystem::path GetRelativePath(const std::filesystem::path& fullPath, std::string_view target_dir);
 
 Script* CompileConditionScript(std::string_view condString);
+// Returns the normalized form of a condition so that entries with the same condition share one compiled script; the
+// view stays valid for the lifetime of the process
+std::string_view InternConditionScriptText(std::string_view condString);
+void LogConditionScriptStats();
 
 struct CaseInsensitiveHash {
 	std::size_t operator()(std::string_view str) const {
@@ -3,6 +3,7 @@
 #include "main.h"
 #include "utility.h"
 #include "SafeWrite.h"
+#include "file_animations.h"
 
 std::string ReplaceAll(std::string str, const std::string& from, const std::string& to) {
 	size_t start_pos = 0;
@@ -115,13 +116,107 @@ std::filesystem::path GetRelativePath(const std::filesystem::path& fullPath, std
 	return relativePath;
 }
 
-std::unordered_map<std::string_view, Script*, CaseInsensitiveHash, CaseInsensitiveEqual> g_conditionScripts;
+// Condition scripts keyed by normalized text, so identical conditions from any number of JSON entries and stacks share
+// one compiled script. Script code is case insensitive but string literals are not, so the key folds case outside of
+// literals only. Entries are never removed since a compiled script can still be referenced by a running script
+// context after the override that used it is gone, which also keeps the text views handed out valid.
+struct ConditionScriptCache
+{
+	struct Entry
+	{
+		std::string text; // normalized with the case of the first condition that used it, what gets compiled
+		Script* script = nullptr;
+		bool compiled = false;
+	};
+
+	std::mutex mutex;
+	std::unordered_map<std::string, Entry> entries;
+	UInt32 numReferences = 0;
+	UInt32 numCompiled = 0;
+	UInt32 numFailed = 0;
+	UInt32 numHits = 0;
+	double compileTimeMs = 0;
+
+	// must hold mutex
+	Entry& GetEntry(std::string_view condString)
+	{
+		auto [iter, isNew] = entries.try_emplace(NormalizeConditionText(condString, true));
+		if (isNew)
+			iter->second.text = NormalizeConditionText(condString, false);
+		return iter->second;
+	}
+
+	// trims and collapses runs of spaces and tabs outside of string literals, optionally lowercasing there as well;
+	// a \" inside a literal doesn't end it
+	static std::string NormalizeConditionText(std::string_view condString, bool foldCase)
+	{
+		std::string result;
+		result.reserve(condString.size());
+		bool inString = false;
+		bool escaped = false;
+		bool pendingSpace = false;
+		for (const char c : condString)
+		{
+			if (inString)
+			{
+				if (escaped)
+					escaped = false;
+				else if (c == '\\')
+					escaped = true;
+				else if (c == '"')
+					inString = false;
+				result.push_back(c);
+				continue;
+			}
+			if (c == ' ' || c == '\t')
+			{
+				pendingSpace = !result.empty();
+				continue;
+			}
+			if (pendingSpace)
+			{
+				result.push_back(' ');
+				pendingSpace = false;
+			}
+			if (c == '"')
+				inString = true;
+			result.push_back(foldCase ? static_cast<char>(std::tolower(static_cast<unsigned char>(c))) : c);
+		}
+		return result;
+	}
+};
+
+ConditionScriptCache g_conditionScripts;
+
+std::string_view InternConditionScriptText(std::string_view condString)
+{
+	std::unique_lock lock(g_conditionScripts.mutex);
+	++g_conditionScripts.numReferences;
+	return g_conditionScripts.GetEntry(condString).text;
+}
+
+void LogConditionScriptStats()
+{
+	std::unique_lock lock(g_conditionScripts.mutex);
+	LOG(FormatString("Condition scripts: %u references, %u distinct, %u compiled (%u failed) in %.2f ms, %u cache hits",
+		g_conditionScripts.numReferences, static_cast<UInt32>(g_conditionScripts.entries.size()), g_conditionScripts.numCompiled,
+		g_conditionScripts.numFailed, g_conditionScripts.compileTimeMs, g_conditionScripts.numHits));
+}
 
 Script* CompileConditionScript(std::string_view condString)
 {
-	auto [iter, isNew] = g_conditionScripts.emplace(condString, nullptr);
-	if (!isNew)
-		return iter->second;
+	// held while compiling so that the same text is never compiled twice and the game compiler is never reentered
+	std::unique_lock lock(g_conditionScripts.mutex);
+	auto& entry = g_conditionScripts.GetEntry(condString);
+	if (entry.compiled)
+	{
+		++g_conditionScripts.numHits;
+		return entry.script;
+	}
+	entry.compiled = true;
+	++g_conditionScripts.numCompiled;
+	const auto startTime = std::chrono::high_resolution_clock::now();
+	condString = entry.text;
 	ScriptBuffer buffer;
 	auto condition = MakeUnique<Script, 0x5AA0F0, 0x5AA1A0>();
 	condition->SetTemporary();
@@ -144,12 +239,13 @@ Script* CompileConditionScript(std::string_view condString)
 	const auto result = ThisStdCall<bool>(0x5AEB90, ctx, condition.get(), &buffer);
 	buffer.scriptText = nullptr;
 	condition->text = nullptr;
+	g_conditionScripts.compileTimeMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
 	if (!result)
 	{
+		++g_conditionScripts.numFailed;
 		ERROR_LOG("Failed to compile condition script " + std::string(condString));
 		return nullptr;
 	}
-	auto* script = condition.release();
-	iter->second = script;
-	return script;
+	entry.script = condition.release();
+	return entry.script;
 }
\ No newline at end of file